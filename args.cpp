@@ -0,0 +1,178 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <Arduino.h>
+#include "cli/args.hpp"
+
+/**
+ * @brief The names of the argument types used by the usage message, indexed
+ * by cliArgType_t. Keywords are listed instead of a type name.
+ */
+static const char* const ArgTypeNames[] = {
+    "int", "uint", "hex", "float", nullptr, "string"
+};
+
+/**
+ * @brief Used to look up a keyword in a list of keywords separated by '|'.
+ *
+ * @return true and the index of the keyword in pIdx if found.
+ */
+static bool findKeyword(const char *list, const char *str, uint32_t *pIdx) {
+    size_t len = strlen(str);
+    uint32_t idx = 0;
+
+    while (list != nullptr) {
+        const char *sep = strchr(list, '|');
+        size_t kwLen = (sep != nullptr) ? (size_t) (sep - list) : strlen(list);
+
+        if (kwLen == len && strncmp(list, str, len) == 0) {
+            *pIdx = idx;
+            return true;
+        }
+
+        list = (sep != nullptr) ? sep + 1 : nullptr;
+        idx++;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Used to convert a single argument according to its spec.
+ *
+ * @return true in case of success, false if the argument is invalid.
+ */
+static bool convertArg(const cliArgSpec_t *pSpec, const char *str,
+                       cliArg_t *pArg) {
+    const char *sign = str;
+    char *end = nullptr;
+    long sval = 0;
+    unsigned long uval = 0;
+
+    errno = 0;
+    switch (pSpec->type) {
+        case cli_arg_int:
+            sval = strtol(str, &end, 10);
+#if LONG_MAX > INT32_MAX
+            if (sval < INT32_MIN || sval > INT32_MAX) {
+                return false;
+            }
+#endif
+            pArg->i = (int32_t) sval;
+            break;
+
+        case cli_arg_uint:
+        case cli_arg_hex:
+            /* strtoul() would skip leading white space, accept a minus and
+             * negate the value */
+            while (isspace((unsigned char) *sign)) {
+                sign++;
+            }
+            if (*sign == '-') {
+                return false;
+            }
+            uval = strtoul(str, &end, pSpec->type == cli_arg_hex ? 16 : 10);
+#if ULONG_MAX > UINT32_MAX
+            if (uval > UINT32_MAX) {
+                return false;
+            }
+#endif
+            pArg->u = (uint32_t) uval;
+            break;
+
+        case cli_arg_float:
+            /* strtod() as strtof() is not available on all platforms */
+            pArg->f = (float) strtod(str, &end);
+            break;
+
+        case cli_arg_keyword:
+            return findKeyword(pSpec->keywords, str, &pArg->u);
+
+        case cli_arg_string:
+            pArg->s = str;
+            return true;
+
+        default:
+            return false;
+    }
+
+    return (end != str) && (*end == '\0') && (errno == 0);
+}
+
+/**
+ * @brief Used to print the usage of a typed command, e.g.
+ * "Usage: led <mode:on|off> [speed:uint]".
+ */
+static void printUsage(Stream& ioStream, const char *name,
+                       const cliArgSpec_t *pSpec, uint8_t cnt,
+                       uint8_t required) {
+    ioStream.printf("Usage: %s", name);
+
+    for (uint8_t i = 0; i < cnt; i++) {
+        const char *type = (pSpec[i].type == cli_arg_keyword) ?
+            pSpec[i].keywords : ArgTypeNames[pSpec[i].type];
+
+        ioStream.printf(i < required ? " <%s:%s>" : " [%s:%s]",
+            pSpec[i].name, type);
+    }
+
+    ioStream.printf("\n");
+}
+
+bool cliConvertArgs(Stream& ioStream, const char *name, const char *argv[],
+                    uint8_t argc, const cliArgSpec_t *pSpec, uint8_t cnt,
+                    uint8_t required, cliArg_t *pArgs) {
+    memset(pArgs, 0, cnt * sizeof(cliArg_t));
+
+    if (argc < required) {
+        ioStream.printf("Error, missing argument: %s\n", pSpec[argc].name);
+        goto err_out;
+    }
+
+    if (argc > cnt) {
+        ioStream.printf("Error, to many arguments (max: %d)\n", cnt);
+        goto err_out;
+    }
+
+    for (uint8_t i = 0; i < argc; i++) {
+        if (!convertArg(&pSpec[i], argv[i], &pArgs[i])) {
+            ioStream.printf("Error, invalid argument %s: %s\n", pSpec[i].name,
+                argv[i]);
+            goto err_out;
+        }
+    }
+
+    return true;
+
+    err_out:
+    printUsage(ioStream, name, pSpec, cnt, required);
+    CliCommand::reject();
+    return false;
+}
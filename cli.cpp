@@ -30,22 +30,94 @@
 #include "cli/ascii.hpp"
 #include "cli/vt100.hpp"
 
-Cli::Cli()
-    : pStream(0),
-      EscMode(esc_false),
-      BufIdx(0),
-      Argc(0),
-      pCmdTab(0),
-      CmdTabSiz(0),
-      EchoEnabled(true)
-{
-    argReset();
+#if CLI_HISTORYSIZ > 0 && CLI_HISTORY_SHARED != 0
+CliHistory Cli::History;
+#endif
+
+Cli::Cli() : pStream(0) {
+    init();
+}
+
+void Cli::end(void) {
+    /* Nothing is written anymore, pending output is dropped */
+    pStream = 0;
+    init();
+#if CLI_RXRINGSIZ > 0
+    RxRing.discard();
+#endif
+#if CLI_HISTORYSIZ > 0 && CLI_HISTORY_SHARED == 0
+    /* The next user of the session must not see the commands of the previous
+     * one */
+#if CLI_HISTORY_JOURNAL != 0
+    History.set_journal(nullptr);
+#endif
+    History.clear();
+#endif
+}
+
+void Cli::init(void) {
+    EscMode = esc_false;
+    EscParam = 0;
+#if CLI_RXCHUNKSIZ > 0
+    RxPos = 0;
+    RxLen = 0;
+#endif
+    BufIdx = 0;
+    CurIdx = 0;
+    EchoEnabled = true;
+    TxHold = false;
+#if CLI_TXBUFSIZ > 0
+    TxLen = 0;
+    TxStats.requested = 0;
+    TxStats.written = 0;
+#endif
+#if CLI_TX_NONBLOCK != 0
+    TxPos = 0;
+    TxStats.dropped = 0;
+    TxStats.stalls = 0;
+#endif
+#if CLI_CMD_TASKS != 0
+    pTask = nullptr;
+    TaskArgc = 0;
+    TaskDrops = 0;
+#endif
+#if CLI_WAKEUP != 0
+    pWakeup = nullptr;
+    pWakeupArg = nullptr;
+#endif
+#if CLI_FRAMED != 0
+    FrameState = frame_idle;
+    FrameIdx = 0;
+    FrameLen = 0;
+    FrameSeq = 0;
+    FrameCrc = 0;
+    FrameTime = 0;
+#endif
+#if CLI_TAB_COMPLETION != 0
+    pTabCmds = nullptr;
+    TabStart = 0;
+    TabFirst = 0;
+    TabCnt = 0;
+    TabLen = 0;
+    TabRepeat = false;
+#endif
+#if CLI_HISTORYSIZ > 0
+    /* Don't use History.rewind() here, a shared history may not have been
+     * constructed yet. The cursor is outdated while the history is empty. */
+    HistCur.seq = 0;
+    HistCur.is_used = false;
+#if CLI_HISTORY_SEARCH > 0
+    SearchLen = 0;
+    Searching = false;
+    SearchHit = false;
+    SearchFailed = false;
+#endif
+#endif
 }
 
 void Cli::begin(Stream *pIoStr, bool sortCmdTab) {
     BufIdx = 0;
-    pCmdTab = CliCommand::getTable();
-    CmdTabSiz = CliCommand::getCmdCnt();
+    CurIdx = 0;
     size_t dropped = CliCommand::getDropCnt();
 
     if (dropped != 0) {
@@ -53,7 +125,8 @@ void Cli::begin(Stream *pIoStr, bool sortCmdTab) {
             dropped);
     }
 
-    if (sortCmdTab) {
+    if (sortCmdTab && !CliCommand::isSorted()) {
+        /* Only sort once if several sessions share the command table */
         CliCommand::sortTable();
     }
 
@@ -61,20 +134,279 @@ void Cli::begin(Stream *pIoStr, bool sortCmdTab) {
 }
 
 void Cli::setStream(Stream *pIoStr) {
+#if CLI_TX_NONBLOCK != 0
+    /* Queued output belongs to the previous stream */
+    TxStats.dropped += TxLen - TxPos;
+    TxPos = 0;
+    TxLen = 0;
+#endif
     pStream = pIoStr;
+#if CLI_CMD_TASKS != 0
+    /* A running task belongs to the previous stream */
+    pTask = nullptr;
+#endif
+#if CLI_FRAMED != 0
+    FrameState = frame_idle;
+#endif
+#if CLI_RXCHUNKSIZ > 0
+    /* Pending data belongs to the previous stream */
+    RxPos = 0;
+    RxLen = 0;
+#endif
     reset();
 }
 
 int8_t Cli::loop(void) {
+#if CLI_CMD_TASKS != 0
+    if (pTask != nullptr && pStream != 0) {
+        /* Input is deferred until the task has finished */
+        int8_t ret = runTask();
+        bool hold = false;
+
+        if (ret == CLI_CMD_BUSY) {
+            return 0;
+        }
+
+        hold = txHold(true);
+        if (CliCommand::takeRejected() && ret != 0) {
+            ret = INT8_MIN;
+        } else if (ret != 0) {
+            txPrintf("Error, cmd fails: %d\n", ret);
+        }
+        reset();
+        txHold(hold);
+        return ret;
+    }
+#endif
+
+#if CLI_RXCHUNKSIZ > 0
+    int8_t ret = 0;
+
+    if (pStream == 0) {
+        return 0;
+    }
+
+#if CLI_TX_NONBLOCK != 0
+    txFlush();
+#endif
+
+#if CLI_RXRINGSIZ > 0
+    if (readRing(&ret)) {
+        return ret;
+    }
+#endif
+
+    /* Keep on reading until the stream has no more data or a command has
+     * been executed, whose return code has to be reported. Fetch the next
+     * chunk only if the previous one has been consumed. ">=" instead of "=="
+     * as a command may have called setStream() meanwhile. */
+    while (true) {
+        bool cmd = false;
+        size_t used = 0;
+
+        if (RxPos >= RxLen) {
+            int avail = pStream->available();
+            if (avail <= 0) {
+                break;
+            }
+
+            /* readBytes() does not block as never more than available() is
+             * requested */
+            RxLen = (uint8_t) pStream->readBytes(RxBuf,
+                (size_t) avail < sizeof(RxBuf) ? (size_t) avail : sizeof(RxBuf));
+            RxPos = 0;
+        }
+
+        used = readInput(&RxBuf[RxPos], RxLen - RxPos, &ret, &cmd);
+        RxPos += (uint8_t) used;
+
+        if (cmd || used == 0) {
+            /* A command has been executed or nothing could be processed */
+            break;
+        }
+    }
+
+    return ret;
+#else
+#if CLI_TX_NONBLOCK != 0
+    if (pStream) {
+        txFlush();
+    }
+#endif
+
+#if CLI_RXRINGSIZ > 0
+    int8_t ret = 0;
+
+    if (pStream && readRing(&ret)) {
+        return ret;
+    }
+#endif
+
     if(pStream && pStream->available()) {
         return read(pStream->read());
     }
 
     return 0;
+#endif
+}
+
+#if CLI_RXRINGSIZ > 0
+bool Cli::readRing(int8_t *pRet) {
+    const char *pData;
+    size_t len = RxRing.peek(pData);
+
+    if (len == 0) {
+        return false;
+    }
+
+    /* peek() returns the bytes up to the end of the ring only, so continue
+     * with the wrapped part. readInput() stops after a command, the rest
+     * stays in the ring. */
+    while (len > 0) {
+        bool cmd = false;
+        size_t used = readInput(pData, len, pRet, &cmd);
+
+        RxRing.consume(used);
+        if (cmd || used == 0) {
+            break;
+        }
+
+        len = RxRing.peek(pData);
+    }
+
+    return true;
+}
+#endif
+
+size_t Cli::read(const char *data, size_t len, int8_t *pRet) {
+    return readInput(data, len, pRet, nullptr);
+}
+
+size_t Cli::readInput(const char *data, size_t len, int8_t *pRet,
+                      bool *pCmd) {
+    size_t idx = 0;
+    int8_t ret = 0;
+    bool hold = false;
+
+#if CLI_CMD_TASKS != 0
+    if (pTask != nullptr) {
+        /* Keep the input until the task has finished */
+        len = 0;
+    }
+#endif
+
+    hold = txHold(true);
+    while (idx < len) {
+#if CLI_FRAMED != 0
+        if (FrameState != frame_idle) {
+            expireFrame();
+        }
+
+        if (FrameState == frame_data) {
+            /* The command line of a request frame is taken at once */
+            idx += frameData(&data[idx], len - idx);
+            continue;
+        }
+#endif
+
+        /* Printable characters can't be part of a special case as long as no
+         * escape sequence is pending, see read(char). So a run of them is
+         * plain data which can be stored and echoed at once. */
+        if ((EscMode == esc_false) && !isSearching() && !isFraming() &&
+            isPlain(data[idx])) {
+            size_t run = 1;
+            size_t space = (CLI_COMMANDSIZ - 1) - BufIdx;
+
+            while ((idx + run < len) && isPlain(data[idx + run])) {
+                run++;
+            }
+
+            if (run <= space) {
+                space = run;
+            }
+
+#if CLI_TAB_COMPLETION != 0
+            TabRepeat = false;
+#endif
+            insert(&data[idx], (uint8_t) space);
+
+            /* Like read(char) ring the bell for each byte which does not fit */
+            for (size_t i = space; i < run; i++) {
+                sendBell();
+            }
+
+            idx += run;
+            ret = 0;
+        } else {
+            bool isCmd = (EscMode == esc_false) && (data[idx] == ascii.ret);
+
+#if CLI_FRAMED != 0
+            if (FrameState > frame_start) {
+                /* Within a frame only its last byte executes a command */
+                isCmd = (FrameState == frame_crc_lo);
+            }
+#endif
+
+            ret = read(data[idx++]);
+            if (isCmd) {
+                /* Return to the caller to report the commands return code */
+                if (pCmd != nullptr) {
+                    *pCmd = true;
+                }
+                break;
+            }
+        }
+    }
+
+    txHold(hold);
+
+    if (pRet != nullptr) {
+        *pRet = ret;
+    }
+
+    return idx;
 }
 
 int8_t Cli::read(char byte) {
     int8_t ret = 0;
+    bool hold = false;
+
+#if CLI_CMD_TASKS != 0
+    if (pTask != nullptr) {
+        /* Unlike the bulk read() the byte can't be left to the caller, at
+         * least tell the user that it has been dropped */
+        TaskDrops++;
+        sendBell();
+        return ret;
+    }
+#endif
+
+    hold = txHold(true);
+
+#if CLI_FRAMED != 0
+    if (FrameState != frame_idle) {
+        expireFrame();
+    }
+
+    if ((FrameState != frame_idle) && handleFrame(byte, ret)) {
+        txHold(hold);
+        return ret;
+    }
+#endif
+
+#if CLI_TAB_COMPLETION != 0
+    if (byte != ascii.tab) {
+        /* Any other input ends a sequence of tabs */
+        TabRepeat = false;
+    }
+#endif
+
+#if CLI_HISTORYSIZ > 0 && CLI_HISTORY_SEARCH > 0
+    if (Searching && handleSearch(byte)) {
+        txHold(hold);
+        return ret;
+    }
+#endif
 
     /* No escape so far but ESC received */
     if ((EscMode == esc_false) && (byte == ascii.esc)) {
@@ -83,7 +415,7 @@ int8_t Cli::read(char byte) {
     /* No escape so far but comand terminator received */
     else if ((EscMode == esc_false) && (byte == ascii.ret)) {
         if(EchoEnabled) {
-            pStream->write(ascii.newline);
+            txWrite(ascii.newline);
         }
 
         if (BufIdx != 0) {
@@ -96,11 +428,34 @@ int8_t Cli::read(char byte) {
     else if ((EscMode == esc_false) &&
              ((byte == ascii.del) || (byte == ascii.bs)))
     {
-        if(BufIdx > 0) {
-            BufIdx--;
-            if(EchoEnabled) {
-                pStream->write(vt100.del);
-            }
+        if(CurIdx > 0) {
+            erase(CurIdx - 1, 1);
+        } else {
+            sendBell();
+        }
+    }
+    /* No escape so far but now ctrl-A has been received. */
+    else if ((EscMode == esc_false) && (byte == ascii.soh)) {
+        moveCursor(0);
+    }
+    /* No escape so far but now ctrl-E has been received. */
+    else if ((EscMode == esc_false) && (byte == ascii.enq)) {
+        moveCursor(BufIdx);
+    }
+    /* No escape so far but now ctrl-W has been received, delete the word
+     * before the cursor. */
+    else if ((EscMode == esc_false) && (byte == ascii.etb)) {
+        uint8_t pos = CurIdx;
+
+        while (pos > 0 && Buffer[pos - 1] == ascii.argsep) {
+            pos--;
+        }
+        while (pos > 0 && Buffer[pos - 1] != ascii.argsep) {
+            pos--;
+        }
+
+        if (pos < CurIdx) {
+            erase(pos, CurIdx - pos);
         } else {
             sendBell();
         }
@@ -113,17 +468,38 @@ int8_t Cli::read(char byte) {
     /* No escape so far but now vertical tab has been received. */
     else if ((EscMode == esc_false) && (byte == ascii.vt)) {
         BufIdx = 0;
+        CurIdx = 0;
         Buffer[0] = '\0';
         clearLine();
         refreshPrompt();
     }
+#if CLI_HISTORYSIZ > 0 && CLI_HISTORY_SEARCH > 0
+    /* No escape so far but now ctrl-R has been received. */
+    else if ((EscMode == esc_false) && (byte == ascii.dc2)) {
+        startSearch();
+    }
+#endif
+#if CLI_FRAMED != 0
+    /* No escape so far but now DLE has been received, may start a frame. */
+    else if ((EscMode == esc_false) && (byte == ascii.dle)) {
+        FrameState = frame_start;
+        FrameTime = millis();
+    }
+#endif
     /* No escape so far but now Tab has been received. */
     else if ((EscMode == esc_false) && (byte == ascii.tab)) {
-        handleTabCompletion();
+        if (CurIdx == BufIdx) {
+            handleTabCompletion();
+        } else {
+            /* Only the end of the line can be completed */
+            sendBell();
+        }
     }
-    /* Escape received and now the CSI character */
-    else if ((EscMode == esc_true) && (byte == ascii.csi)) {
+    /* Escape received and now the CSI or the SS3 character */
+    else if ((EscMode == esc_true) &&
+             ((byte == ascii.csi) || (byte == ascii.ss3))) {
         EscMode = esc_csi;
+        EscParam = 0;
     }
     /* Handle a ANSI escape sequence */
     else if (EscMode == esc_csi) {
@@ -136,32 +512,17 @@ int8_t Cli::read(char byte) {
          * are consumed and ignored here so they don't leak into Buffer as
          * ordinary input, only the final byte is acted upon.
          */
-        if (byte >= 0x30 && byte <= 0x3F) {
-            /* Parameter byte, keep waiting for the final byte */
-        } else {
-            switch (byte) {
-                case 'A':
-                    /* Up Key pressed */
-                    restoreLastCmd();
-                    break;
-
-                case 'B':
-                    /* Down Key pressed */
-                    restoreNextCmd();
-                    break;
-
-                case 'C':
-                    /* Right Key pressed */
-                    break;
-
-                case 'D':
-                    /* Left Key pressed */
-                    break;
-
-                default:
-                    break;
+        if (byte >= '0' && byte <= '9') {
+            /* Parameter digit, keep waiting for the final byte */
+            if (EscParam < 100) {
+                EscParam = EscParam * 10 + (byte - '0');
             }
-
+        } else if (byte >= 0x30 && byte <= 0x3F) {
+            /* A separator or modifier, e.g. ctrl-Delete sends ESC [ 3 ; 5 ~,
+             * which is not supported */
+            EscParam = UINT8_MAX;
+        } else {
+            handleCsi(byte);
             EscMode = esc_false;
         }
     }
@@ -175,10 +536,7 @@ int8_t Cli::read(char byte) {
              * pressing enter later on. therefore the check above must respect
              * this: ( BufIdx < ( CLI_COMMANDSIZ - 1) )
              */
-            Buffer[BufIdx++] = byte;
-            if(EchoEnabled) {
-                pStream->write(byte);
-            }
+            insert(&byte, 1);
         } else {
             sendBell();
         }
@@ -186,54 +544,230 @@ int8_t Cli::read(char byte) {
         EscMode = esc_false;
     }
 
-    cli_fflush();
+    txHold(hold);
     return ret;
 }
 
+void Cli::handleCsi(char byte) {
+    switch (byte) {
+        case 'A':
+            /* Up Key pressed */
+            restoreLastCmd();
+            break;
+
+        case 'B':
+            /* Down Key pressed */
+            restoreNextCmd();
+            break;
+
+        case 'C':
+            /* Right Key pressed */
+            if (CurIdx < BufIdx) {
+                moveCursor(CurIdx + 1);
+            }
+            break;
+
+        case 'D':
+            /* Left Key pressed */
+            if (CurIdx > 0) {
+                moveCursor(CurIdx - 1);
+            }
+            break;
+
+        case 'H':
+            /* Home Key pressed */
+            moveCursor(0);
+            break;
+
+        case 'F':
+            /* End Key pressed */
+            moveCursor(BufIdx);
+            break;
+
+        case '~':
+            /* The key is given by the parameter, see EscParam */
+            if (EscParam == 1 || EscParam == 7) {
+                moveCursor(0);
+            } else if (EscParam == 4 || EscParam == 8) {
+                moveCursor(BufIdx);
+            } else if (EscParam == 3) {
+                /* Delete Key pressed */
+                if (CurIdx < BufIdx) {
+                    erase(CurIdx, 1);
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+void Cli::insert(const char *data, uint8_t len) {
+    uint8_t tail = BufIdx - CurIdx;
+
+    if (len == 0) {
+        return;
+    }
+
+    /* Make room at the cursor, nothing to move if it is at the end */
+    memmove(&Buffer[CurIdx + len], &Buffer[CurIdx], tail);
+    memcpy(&Buffer[CurIdx], data, len);
+    BufIdx += len;
+
+    if (EchoEnabled) {
+        /* The inserted data shifts the tail, so it has to be redrawn */
+        txWrite(&Buffer[CurIdx], len + tail);
+        cursorBack(tail);
+    }
+
+    CurIdx += len;
+}
+
+void Cli::erase(uint8_t pos, uint8_t len) {
+    uint8_t tail = BufIdx - (pos + len);
+
+    memmove(&Buffer[pos], &Buffer[pos + len], tail);
+    BufIdx -= len;
+
+    if (EchoEnabled) {
+        cursorBack(CurIdx - pos);
+        txWrite(&Buffer[pos], tail);
+        txWrite(vt100.clreol);
+        cursorBack(tail);
+    }
+
+    CurIdx = pos;
+}
+
+void Cli::moveCursor(uint8_t pos) {
+    if (EchoEnabled) {
+        uint8_t cnt = pos - CurIdx;
+
+        if (pos < CurIdx) {
+            cursorBack(CurIdx - pos);
+        } else if (cnt > sizeof(vt100.left) - 1) {
+            txPrintf("\033[%uC", (unsigned) cnt);
+        } else {
+            /* Rewriting a few characters is shorter than a CUF sequence */
+            txWrite(&Buffer[CurIdx], cnt);
+        }
+    }
+
+    CurIdx = pos;
+}
+
+void Cli::cursorBack(uint8_t cnt) {
+    if (cnt > sizeof(vt100.left) - 1) {
+        txPrintf("\033[%uD", (unsigned) cnt);
+    } else if (cnt > 0) {
+        txWrite(vt100.left, cnt);
+    }
+}
+
 void Cli::setEcho(bool state) {
     EchoEnabled = state;
 }
 
 void Cli::sendBell(void) {
-    pStream->write(ascii.bell);
+    txWrite(ascii.bell);
 }
 
 void Cli::refreshPrompt(void) {
-    pStream->write(CLI_PROMPT);
-    pStream->write(Buffer, BufIdx);
+    txWrite(CLI_PROMPT);
+    txWrite(Buffer, BufIdx);
+    cursorBack(BufIdx - CurIdx);
 }
 
 void Cli::clearLine(void) {
-    pStream->write(vt100.clrline);
+    txWrite(vt100.clrline);
 }
 
 void Cli::clearScreen(void) {
-    pStream->write(vt100.clrscr);
+    txWrite(vt100.clrscr);
 }
 
 void Cli::saveCursor(void) {
-    pStream->write(vt100.savecur);
+    txWrite(vt100.savecur);
 }
 
 void Cli::restoreCursor(void) {
-    pStream->write(vt100.restorecur);
+    txWrite(vt100.restorecur);
+}
+
+#if CLI_HISTORYSIZ > 0
+bool Cli::recallLine(void) {
+    const char *seg[2];
+    size_t seglen[2];
+    size_t len = History.peek(HistCur, seg, seglen);
+    uint8_t oldLen = BufIdx;
+    uint8_t common = 0;
+
+    if (len == 0 || len >= sizeof(Buffer)) {
+        return false;
+    }
+
+    /* Find the part the line on the screen and the recalled one have in
+     * common, the recalled line may wrap around in the history */
+    for (uint8_t s = 0; s < 2; s++) {
+        size_t i = 0;
+
+        while (i < seglen[s] && common < oldLen &&
+               Buffer[common] == seg[s][i]) {
+            common++;
+            i++;
+        }
+
+        if (i < seglen[s]) {
+            break;
+        }
+    }
+
+    BufIdx = (uint8_t) History.read(HistCur, Buffer, sizeof(Buffer));
+    redrawLine(common, oldLen);
+    return true;
+}
+#endif
+
+void Cli::redrawLine(uint8_t common, uint8_t oldLen) {
+    if (EchoEnabled) {
+        /* Move to the end of the common part, which is the same in the old
+         * and in the new line */
+        if (CurIdx > common) {
+            cursorBack(CurIdx - common);
+        } else if (CurIdx < common) {
+            txWrite(&Buffer[CurIdx], common - CurIdx);
+        }
+
+        if (BufIdx > common) {
+            txWrite(&Buffer[common], BufIdx - common);
+        }
+
+        if (oldLen > BufIdx) {
+            /* The rest of the old line is still on the screen */
+            txWrite(vt100.clreol);
+        }
+    }
+
+    CurIdx = BufIdx;
 }
 
 bool Cli::restoreLastCmd(void) {
 #if CLI_HISTORYSIZ > 0
-    if (History.is_used == true) {
-        if (History.seek_backward() == false) {
+    if (HistCur.is_used == true) {
+        if (History.seek_backward(HistCur) == false) {
             goto err_out;
         }
+    } else {
+        /* Start at the most recent line, another session sharing the history
+         * may have added one since the last command */
+        History.rewind(HistCur);
     }
 
-    BufIdx = (uint8_t) History.read(Buffer, sizeof(Buffer));
-    if (BufIdx == 0) {
+    if (recallLine() == false) {
         goto err_out;
     }
-    clearLine();
-    refreshPrompt();
-    History.is_used = true;
+    HistCur.is_used = true;
     return true;
 
     err_out:
@@ -247,13 +781,14 @@ bool Cli::restoreLastCmd(void) {
 
 bool Cli::restoreNextCmd(void) {
 #if CLI_HISTORYSIZ > 0
-    if (History.is_used == true) {
-        if (History.seek_forward() == false) {
-            History.is_used = false;
+    if (HistCur.is_used == true) {
+        if (History.seek_forward(HistCur) == false) {
+            uint8_t oldLen = BufIdx;
+
+            HistCur.is_used = false;
             BufIdx = 0;
             Buffer[0] = 0;
-            clearLine();
-            refreshPrompt();
+            redrawLine(0, oldLen);
             return true;
         }
     } else {
@@ -261,12 +796,9 @@ bool Cli::restoreNextCmd(void) {
         goto err_out;
     }
 
-    BufIdx = (uint8_t) History.read(Buffer, sizeof(Buffer));
-    if (BufIdx == 0) {
+    if (recallLine() == false) {
         goto err_out;
     }
-    clearLine();
-    refreshPrompt();
     return true;
 
     err_out:
@@ -280,7 +812,6 @@ bool Cli::restoreNextCmd(void) {
 
 int8_t Cli::checkCmdTable(void)
 {
-    uint8_t i = 0;
     int8_t ret = 0;
     bool hasContent = false;
 
@@ -301,153 +832,344 @@ int8_t Cli::checkCmdTable(void)
          * Just ignore it and return to the prompt
          */
         ret = 0;
-        goto out_2;
+        goto out;
     }
 
 #if CLI_HISTORYSIZ > 0
     History.append(Buffer, BufIdx);
-    History.is_used = false;
+    History.rewind(HistCur);
 #endif
 
-    for(i=0; i<CmdTabSiz; i++) {
-        if (checkCmd(&pCmdTab[i])) {
-            if (!parseArgs(strlen(pCmdTab[i].name))) {
-                /* parseArgs() has already printed a specific error message */
-                ret=INT8_MIN;
-                goto out_2;
+    ret = dispatch(Buffer, true);
+
+#if CLI_CMD_TASKS != 0
+    if (pTask != nullptr) {
+        /* Called again by loop(), the prompt is printed when it has
+         * finished */
+        return 0;
+    }
+#endif
+
+    out:
+    reset();
+    return ret;
+}
+
+int8_t Cli::dispatch(char *buf, bool defer) {
+    uint8_t len = 0;
+    int8_t ret = 0;
+    const cliCmd_t *pCmd = 0;
+    bool hold = false;
+    cliArgs_t args;
+
+    /* The command name is terminated by the first argument separator */
+    while (buf[len] != '\0' && buf[len] != ascii.argsep) {
+        len++;
+    }
+
+#if CLI_PREFIX_MATCH != 0
+    size_t first;
+    size_t matches;
+
+    pCmd = CliCommand::resolve(CliCommand::getTable(),
+        CliCommand::getCmdCnt(), buf, len, first, matches);
+    if (matches > 1) {
+        const cliCmd_t *pTab = CliCommand::getTable();
+
+        txWrite("Error, ambiguous command: ");
+        txWrite(buf, len);
+        txWrite(ascii.newline);
+        txWrite("Matches:");
+        /* In an unsorted table the matches are not one range, so names
+         * following the first match are filtered by the prefix */
+        for (size_t i = first; matches > 0; i++) {
+            if (strncmp(pTab[i].name, buf, len) == 0) {
+                txWrite(ascii.argsep);
+                txWrite(pTab[i].name);
+                matches--;
             }
+        }
+        txWrite(ascii.newline);
+        buf[0] = 0;
+        return INT8_MIN;
+    }
+#else
+    pCmd = CliCommand::find(buf, len);
+#endif
+    if (pCmd == 0) {
+        txWrite("Error, unknown command: ");
+        txWrite(buf);
+        txWrite(ascii.newline);
+        /* Setting buf[0] to zero prevents printing the invalid command again */
+        buf[0] = 0;
+        return INT8_MIN;
+    }
 
-            ret=pCmdTab[i].pfunc(*pStream, (const char **)Argv, Argc);
-            goto out;
+    if (!parseArgs(buf, len, args)) {
+        /* parseArgs() has already printed a specific error message */
+        return INT8_MIN;
+    }
+
+#if CLI_CMD_TASKS != 0
+    if (defer && pCmd->ptask != nullptr) {
+        memcpy(TaskArgv, args.argv, sizeof(TaskArgv));
+        TaskArgc = args.argc;
+        memset(&TaskCtx, 0, sizeof(TaskCtx));
+        pTask = pCmd;
+
+        ret = runTask();
+        if (ret == CLI_CMD_BUSY) {
+            return ret;
         }
+        goto out;
     }
+#else
+    (void) defer;
+#endif
 
-    pStream->printf("Error, unknown command: %s\n", Buffer);
-    /* Setting Buffer[0] to zero prevents printing the invalid command again */
-    Buffer[0] = 0;
-    ret=INT8_MIN;
-    goto out_2;
+    /* The command writes to the stream directly, so pending output has 
+     * to be written before and any output produced by calls to this 
+     * object from within the command must not be held back. */
+    txDrain();
+    hold = txHold(false);
+    ret=CliCommand::invoke(pCmd, *pStream, (const char **)args.argv, args.argc);
+    txHold(hold);
 
+#if CLI_CMD_TASKS != 0
     out:
-    if (ret != 0) {
-        pStream->printf("Error, cmd fails: %d\n", ret);
+#endif
+    /* Invalid arguments have been explained by a specific error message
+     * already, see CliCommand::reject(). Reported like a parsing error. */
+    if (CliCommand::takeRejected() && ret != 0) {
+        ret = INT8_MIN;
+    } else if (ret != 0) {
+        txPrintf("Error, cmd fails: %d\n", ret);
     }
 
-    out_2:
-    reset();
     return ret;
 }
 
-bool Cli::checkCmd(cliCmd_t *p_cmd) {
-    uint8_t i = 0;
+int8_t Cli::execLine(const char *line, size_t len) {
+    char buf[CLI_COMMANDSIZ];
+    int8_t ret = 0;
+    bool hold = false;
+    size_t k = 0;
 
-    if(!p_cmd->name[0]) {
-        /* the command is empty */
-        return false;
+    /* A trailing line terminator is not part of the command */
+    while (len > 0 && (line[len - 1] == ascii.ret || 
+                       line[len - 1] == ascii.newline)) {
+        len--;
     }
 
-    while (p_cmd->name[i]) {
-        if (p_cmd->name[i] != Buffer[i]) {
-            /* the given command does not match the expected command */
-            return false;
-        }
+    /* Same as typed input, a whitespace-only line is ignored, see
+     * checkCmdTable() */
+    while (k < len && (line[k] == ascii.argsep || line[k] == ascii.tab)) {
+        k++;
+    }
 
-        i++;
+    if (k == len) {
+        return 0;
     }
 
-    if (Buffer[i] != '\0' && Buffer[i] != ascii.argsep) {
-        /* the given command is longer then the expected command */
-        return false;
+    if (len >= sizeof(buf)) {
+        txPrintf("Error, command too long (max: %d)\n", CLI_COMMANDSIZ - 1);
+        return INT8_MIN;
     }
 
-    return true;
+    /* Parsed in a copy, so the input of the terminal is not affected */
+    memcpy(buf, line, len);
+    buf[len] = 0;
+
+    hold = txHold(true);
+    ret = dispatch(buf, false);
+    txHold(hold);
+
+    return ret;
 }
 
-bool Cli::parseArgs(uint8_t startIdx) {
-    uint8_t i = startIdx;
-    uint8_t j = 0;
+bool Cli::parseArgs(char *buf, uint8_t startIdx, cliArgs_t &args) {
+    /* Single forward pass with separate read and write positions. Removing a
+     * escape character just means that the write position falls behind the
+     * read position, so the remaining buffer doesn't have to be shifted and
+     * the parsing time is linear in the length of the input. As the write
+     * position never gets ahead of the read position, parsing can be done in
+     * place. */
+    uint8_t rd = startIdx;
+    uint8_t wr = startIdx;
     bool string = false;
+    char c = 0;
 
-    argReset();
+    memset(&args, 0, sizeof(args));
 
-    while (Buffer[i] != 0) {
-        /* Handle escape sequences within strings */
-        if (Buffer[i] == '\\' && Buffer[i+1] != 0 && string) {
-            /* Remove the backslash by shifting remaining chars */
-            j = i;
-            while (Buffer[j] != 0) {
-                Buffer[j] = Buffer[j+1];
-                j++;
-            }
-            /* The escaped character is now at position i
-             * Don't increment i, let the normal flow handle the next char
-             */
-        } else if (Buffer[i] == ascii.stresc) {
+    while (buf[rd] != 0) {
+        c = buf[rd++];
+
+        if (string && (c == '\\') && (buf[rd] != 0)) {
+            /* Escape sequence within a string, drop the backslash and take the
+             * escaped character as it is */
+            buf[wr++] = buf[rd++];
+        } else if (c == ascii.stresc) {
             if (string) {
                 /* End of string */
                 string = false;
-                Buffer[i] = 0;
+                buf[wr++] = 0;
             } else {
-                /* This is a starting quote, but not at the beginning of an argument
-                 * Ignore and treat it as part of the argument
-                 */
+                /* This is a starting quote, but not at the beginning of an
+                 * argument. Ignore and treat it as part of the argument */
+                buf[wr++] = c;
             }
-        } else if ((Buffer[i] == ascii.argsep) && (string == false)) {
-            /* Assumtion: A new argument starts after the argument separator */
-            while (Buffer[i] == ascii.argsep) {
-                /* Consume all argument separators to find the start of the argument */
-                Buffer[i++] = 0;
+        } else if ((c == ascii.argsep) && (string == false)) {
+            /* Assumtion: A new argument starts after the argument separator.
+             * Terminate the previous one and consume all further argument 
+             * separators to find the start of the argument */
+            buf[wr++] = 0;
+            while (buf[rd] == ascii.argsep) {
+                rd++;
             }
 
-            if (Buffer[i] == 0) {
-                /* EOB reached, assumtion above was wrong, nothing left to parse, return */
+            if (buf[rd] == 0) {
+                /* EOB reached, assumtion above was wrong, nothing left to
+                 * parse, return */
                 return true;
             }
 
-            if (Argc == CLI_ARGVSIZ) {
-                pStream->printf("Error, to many arguments (max: %d)\n", CLI_ARGVSIZ);
+            if (args.argc == CLI_ARGVSIZ) {
+                txPrintf("Error, to many arguments (max: %d)\n", CLI_ARGVSIZ);
                 return false;
             }
 
-            if (Buffer[i] == ascii.stresc){
+            if (buf[rd] == ascii.stresc){
                 string = true;
-                Buffer[i++] = 0;
-                StringArg[Argc] = true;
+                rd++;
+                args.string[args.argc] = true;
             }
 
-            Argv[Argc] = &Buffer[i];
-            Argc++;
-        }
+            args.argv[args.argc] = &buf[wr];
+            args.argc++;
 
-        i++;
+            /* The first character of a argument is always taken as it is,
+             * even if it is a quote or backslash */
+            if (buf[rd] != 0) {
+                buf[wr++] = buf[rd++];
+            }
+        } else {
+            buf[wr++] = c;
+        }
     }
 
+    buf[wr] = 0;
+
     if (string) {
         /* Unterminated string detected */
-        pStream->printf("Error, unterminated string argument\n");
+        txWrite("Error, unterminated string argument\n");
         return false;
     }
 
     return true;
 }
 
-void Cli::argReset(void) {
-    Argc=0;
-    memset(Argv, 0, sizeof(Argv));
+#if CLI_CMD_TASKS != 0
+
+int8_t Cli::runTask(void) {
+    int8_t ret = 0;
+    bool hold = false;
+
+    /* Same as for ordinary commands, see checkCmdTable() */
+    txDrain();
+    hold = txHold(false);
+    ret = CliCommand::resume(pTask, *pStream, TaskArgv, TaskArgc, TaskCtx);
+    txHold(hold);
+
+    if (ret != CLI_CMD_BUSY) {
+        pTask = nullptr;
+    }
+
+    return ret;
+}
+
+bool Cli::isBusy(void) {
+    return pTask != nullptr;
+}
+
+uint32_t Cli::getTaskDrops(void) {
+    return TaskDrops;
+}
+
+#endif
+
+bool Cli::hasPendingWork(void) {
+    if (pStream == 0) {
+        return false;
+    }
+
+#if CLI_CMD_TASKS != 0
+    if (pTask != nullptr) {
+        return true;
+    }
+#endif
+
+#if CLI_TX_NONBLOCK != 0
+    if (TxPos < TxLen) {
+        return true;
+    }
+#endif
+
+#if CLI_RXCHUNKSIZ > 0
+    if (RxPos < RxLen) {
+        return true;
+    }
+#endif
 
-    for(uint8_t i = 0; i < CLI_ARGVSIZ; i++) {
-        StringArg[i] = false;
+#if CLI_RXRINGSIZ > 0
+    if (!RxRing.isEmpty()) {
+        return true;
     }
+#endif
+
+    return pStream->available() > 0;
 }
 
+#if CLI_WAKEUP != 0
+void Cli::setWakeup(CliWakeupPtr pFunc, void *pArg) {
+    pWakeup = pFunc;
+    pWakeupArg = pArg;
+}
+#endif
+
 void Cli::reset(void) {
     BufIdx = 0;
+    CurIdx = 0;
     EscMode = esc_false;
 
 #if CLI_HISTORYSIZ > 0
-    History.is_used = false;
+    History.rewind(HistCur);
+#if CLI_HISTORY_SEARCH > 0
+    Searching = false;
+#endif
+#endif
+
+#if CLI_TAB_COMPLETION != 0
+    TabCnt = 0;
+    TabRepeat = false;
 #endif
 
     refreshPrompt();
-    cli_fflush();
 }
+
+#if CLI_HISTORYSIZ > 0 && CLI_HISTORY_JOURNAL != 0
+
+size_t Cli::setJournal(CliJournal *pJournal) {
+    size_t cnt = 0;
+
+    /* Don't write the restored lines back to the journal */
+    History.set_journal(nullptr);
+    if (pJournal != nullptr) {
+        cnt = pJournal->restore(History);
+        History.set_journal(pJournal);
+    }
+    History.rewind(HistCur);
+
+    return cnt;
+}
+
+#endif
@@ -0,0 +1,186 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#include "cli/command.hpp"
+
+/**
+ * @brief Used to define and register a libcli command with typed arguments.
+ *
+ * The arguments are declared by a list of CLI_ARG_*() specs. They are
+ * validated and converted before the command is called, which gets them as
+ * array of cliArg_t in the same order. If the user input does not match, an
+ * error message and the usage of the command is printed and the command
+ * returns INT8_MIN without calling the body, see CliCommand::reject().
+ *
+ * @param _name     The name of the command.
+ * @param _required The number of arguments which must be given, the
+ *                  remaining ones are optional and zero if omitted.
+ * @param ...       The specs of the arguments, at least one.
+ */
+#define CLI_COMMAND_TYPED(_name, _required, ...)                    \
+                                                                    \
+    static const cliArgSpec_t _name ## _argspec[] = { __VA_ARGS__ };\
+    static const uint8_t _name ## _argcnt =                         \
+        sizeof(_name ## _argspec) / sizeof(_name ## _argspec[0]);   \
+    static_assert((_required) <= _name ## _argcnt,                  \
+        "More required arguments than specs");                      \
+    static_assert(_name ## _argcnt <= CLI_ARGVSIZ,                  \
+        "More argument specs than CLI_ARGVSIZ");                    \
+    int8_t typed_ ## _name(Stream& ioStream, const cliArg_t args[], \
+        uint8_t argc);                                              \
+    CLI_COMMAND(_name) {                                            \
+        cliArg_t args[_name ## _argcnt];                            \
+        if (!cliConvertArgs(ioStream, #_name, argv, argc,           \
+                _name ## _argspec, _name ## _argcnt, (_required),   \
+                args)) {                                            \
+            return INT8_MIN;                                        \
+        }                                                           \
+        return typed_ ## _name(ioStream, args, argc);               \
+    }                                                               \
+    int8_t typed_ ## _name(Stream& ioStream, const cliArg_t args[], \
+        uint8_t argc)
+
+/**
+ * @brief Spec of a signed decimal integer argument, converted to cliArg_t::i.
+ */
+#define CLI_ARG_INT(_name)          { cli_arg_int, _name, nullptr }
+
+/**
+ * @brief Spec of a unsigned decimal integer argument, converted to
+ * cliArg_t::u.
+ */
+#define CLI_ARG_UINT(_name)         { cli_arg_uint, _name, nullptr }
+
+/**
+ * @brief Spec of a hexadecimal argument with optional 0x prefix, converted to
+ * cliArg_t::u.
+ */
+#define CLI_ARG_HEX(_name)          { cli_arg_hex, _name, nullptr }
+
+/**
+ * @brief Spec of a floating point argument, converted to cliArg_t::f.
+ */
+#define CLI_ARG_FLOAT(_name)        { cli_arg_float, _name, nullptr }
+
+/**
+ * @brief Spec of a keyword argument, one of the given keywords separated by
+ * '|', e.g. "on|off". The index of the keyword is stored in cliArg_t::u.
+ */
+#define CLI_ARG_KEYWORD(_name, _keywords)                           \
+                                                                    \
+    { cli_arg_keyword, _name, _keywords }
+
+/**
+ * @brief Spec of a string argument, stored in cliArg_t::s.
+ */
+#define CLI_ARG_STRING(_name)       { cli_arg_string, _name, nullptr }
+
+/**
+ * @brief The types of typed command arguments.
+ */
+typedef enum : uint8_t {
+    cli_arg_int = 0,
+    cli_arg_uint,
+    cli_arg_hex,
+    cli_arg_float,
+    cli_arg_keyword,
+    cli_arg_string
+} cliArgType_t;
+
+/**
+ * @brief The spec of a typed command argument, created by CLI_ARG_*().
+ */
+typedef struct {
+
+    /**
+     * @brief The type of the argument.
+     */
+    cliArgType_t type;
+
+    /**
+     * @brief The name of the argument, used for error messages and usage.
+     */
+    const char *name;
+
+    /**
+     * @brief The keywords separated by '|' if the type is cli_arg_keyword.
+     */
+    const char *keywords;
+
+} cliArgSpec_t;
+
+/**
+ * @brief A converted typed command argument, the member to use is given by
+ * the type of the argument spec.
+ */
+typedef union {
+
+    /**
+     * @brief Value of a cli_arg_int argument.
+     */
+    int32_t i;
+
+    /**
+     * @brief Value of a cli_arg_uint or cli_arg_hex argument, or the index of
+     * the keyword of a cli_arg_keyword argument.
+     */
+    uint32_t u;
+
+    /**
+     * @brief Value of a cli_arg_float argument.
+     */
+    float f;
+
+    /**
+     * @brief Value of a cli_arg_string argument.
+     */
+    const char *s;
+
+} cliArg_t;
+
+/**
+ * @brief Used to validate and convert the arguments of a typed command, see
+ * CLI_COMMAND_TYPED(). Prints an error message and the usage of the command
+ * if the arguments don't match their specs and rejects them by
+ * CliCommand::reject().
+ *
+ * @param ioStream  The stream to print error messages to.
+ * @param name      The name of the command.
+ * @param argv      The arguments of the command.
+ * @param argc      The number of arguments.
+ * @param pSpec     The specs of the arguments.
+ * @param cnt       The number of specs.
+ * @param required  The number of arguments which must be given.
+ * @param pArgs     Receives the converted arguments, cnt entries. Omitted
+ *                  optional arguments are set to zero.
+ *
+ * @return true     If all arguments have been converted.
+ * @return false    Otherwise.
+ */
+bool cliConvertArgs(Stream& ioStream, const char *name, const char *argv[],
+    uint8_t argc, const cliArgSpec_t *pSpec, uint8_t cnt, uint8_t required,
+    cliArg_t *pArgs);
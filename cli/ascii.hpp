@@ -34,7 +34,8 @@ const struct {
     const char argsep = ' ';
 
     /**
-     * @brief Defines the sequence to echo to trigger the terminal bell.
+     * @brief Defines the sequence to echo to trigger the terminal bell. Also
+     * received in case of ctrl-G.
      */
     const char bell = '\a';
 
@@ -43,6 +44,35 @@ const struct {
      */
     const char bs = '\b';
 
+    /**
+     * @brief Definition of the start of heading character. Sent in case of
+     * ctrl-A.
+     */
+    const char soh = 0x01;
+
+    /**
+     * @brief Definition of the enquiry character. Sent in case of ctrl-E.
+     */
+    const char enq = 0x05;
+
+    /**
+     * @brief Definition of the end of transmission block character. Sent in
+     * case of ctrl-W.
+     */
+    const char etb = 0x17;
+
+    /**
+     * @brief Definition of the device control 2 character. Sent in case of
+     * ctrl-R.
+     */
+    const char dc2 = 0x12;
+
+    /**
+     * @brief Definition of the data link escape character. Starts a frame,
+     * see CLI_FRAMED.
+     */
+    const char dle = 0x10;
+
     /**
      * @brief Definition of the form feed character. Sent in case of ctrl-L.
      */
@@ -53,6 +83,13 @@ const struct {
      */
     const char csi = '[';
 
+    /**
+     * @brief Definition of the single shift 3 character. Follows the escape
+     * character instead of the csi character for some keys, e.g. Home and
+     * End in the application cursor key mode.
+     */
+    const char ss3 = 'O';
+
     /**
      * @brief Definition of the delete character.
      */
@@ -73,6 +110,12 @@ const struct {
      */
     const char ret = '\r';
 
+    /**
+     * @brief Definition of the start of text character. Follows the data
+     * link escape character at the start of a frame.
+     */
+    const char stx = 0x02;
+
     /**
      * @brief Character which is used to mark the begin and the end of a
      * string which shall be recognized as singe argument althow it contains
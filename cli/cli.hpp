@@ -32,11 +32,92 @@
 #include "cli/config.hpp"
 #include "cli/version.h"
 #include "cli/command.hpp"
+#include "cli/args.hpp"
 #include "cli/history.hpp"
+#include "cli/journal.hpp"
+#include "cli/frame.hpp"
+#include "cli/ring.hpp"
 
 #define __STDC_LIMIT_MACROS
 #include <stdint.h>
 
+/**
+ * @brief The arguments of a command line, see Cli::parseArgs().
+ *
+ * Kept on the stack of each dispatch, so a command may execute a further
+ * line by Cli::execLine() without overwriting the arguments of its caller.
+ */
+typedef struct {
+
+    /**
+     * @brief The argument filed to be passed to called user functins.
+     *
+     * Limitation: dont want to use malloc, so define the size statically.
+     * This means that the maximum number of arguments is limited, thats OK
+     * for now.
+     */
+    char *argv[CLI_ARGVSIZ];
+
+    /**
+     * @brief States if the particular argument is a sting or not.
+     */
+    bool string[CLI_ARGVSIZ];
+
+    /**
+     * @brief The number of detected arguments.
+     */
+    uint8_t argc;
+
+} cliArgs_t;
+
+#if CLI_TXBUFSIZ > 0
+/**
+ * @brief Counters of the output staging buffer, see Cli::getTxStats().
+ */
+typedef struct {
+
+    /**
+     * @brief Number of write requests issued by the library.
+     */
+    uint32_t requested;
+
+    /**
+     * @brief Number of resulting Stream::write() calls. The difference to
+     * requested is the number of writes saved by the staging buffer.
+     */
+    uint32_t written;
+
+#if CLI_TX_NONBLOCK != 0
+    /**
+     * @brief Number of bytes dropped as they did not fit into the queue.
+     */
+    uint32_t dropped;
+
+    /**
+     * @brief Number of times output has been kept in the queue as the stream
+     * was not able to take all of it.
+     */
+    uint32_t stalls;
+#endif
+
+} cliTxStats_t;
+#endif
+
+#if CLI_WAKEUP != 0
+/**
+ * @brief The wakeup function, see Cli::setWakeup().
+ */
+typedef void (*CliWakeupPtr)(void *pArg);
+#endif
+
+/**
+ * @brief The command line interface.
+ *
+ * Each instance is a independent session on its own stream, e.g. one for the
+ * serial port and one per telnet client. The command table is shared by all
+ * of them, the command history only if CLI_HISTORY_SHARED is enabled. See
+ * CliPool in cli/pool.hpp to manage a set of sessions.
+ */
 class Cli {
 
     public:
@@ -53,12 +134,13 @@ class Cli {
          * @param pIoStr Optional, the stream to use for read and write.
          * @param sortCmdTab Optional, whether to sort the command table during 
          * initialization. If set to false, the command table will be used in 
-         * the order of registration, which is undefined. This is only relevant
-         * if command completion is enabled, as the command table should be 
-         * sorted to provide sorted coammnd suggestions. Sorting suggestions 
-         * on every command completion is not ideal, so the design is based on 
-         * the assumption that the command table is sorted during 
-         * initialization.
+         * the order of registration, which is undefined. A sorted table is
+         * used as index to look up commands by binary search, an unsorted one
+         * has to be searched linearly. Furthermore the command table should 
+         * be sorted to provide sorted coammnd suggestions if command 
+         * completion is enabled. Sorting suggestions on every command 
+         * completion is not ideal, so the design is based on the assumption
+         * that the command table is sorted during initialization.
          */
         void begin(Stream *pIoStr = &Serial, 
                 bool sortCmdTab = CLI_CMDTAB_SORTING_DEFAULT);
@@ -73,6 +155,17 @@ class Cli {
          */
         void setStream(Stream *pIoStr);
 
+        /**
+         * @brief Used to end the session, e.g. as the client disconnected.
+         *
+         * The session is set back to the state after construction: No
+         * stream, echo enabled, no running task, queued output and pending
+         * input dropped, wakeup callback and statistics cleared. The own
+         * history is cleared and its journal detached, a shared history is
+         * kept. The session may be started again by begin() or setStream().
+         */
+        void end(void);
+
         /**
          * @brief The function to call in loop()
          *
@@ -81,6 +174,20 @@ class Cli {
          * command has been detected the corresponding function will be
          * called.
          *
+         * If CLI_RXCHUNKSIZ is not zero, all available data is fetched in
+         * chunks of up to CLI_RXCHUNKSIZ bytes and processed in bulk until
+         * the stream has no more data. Each call returns after at most one
+         * executed command, so bytes following a command within the same
+         * chunk are kept and processed by the next call. This way the return
+         * code of every command is reported.
+         *
+         * If CLI_TX_NONBLOCK is enabled, queued output is written as far as
+         * the stream is able to take it.
+         *
+         * While a task command is running, see CLI_COMMAND_TASK(), it is
+         * called once per call instead and no input is processed. The prompt
+         * is printed when it has finished.
+         *
          * @return  Zero if no comamnd has been recognized.
          *          INT8_MIN in case of an parsing related error.
          *          The return code of the command which has been recognized,
@@ -91,6 +198,11 @@ class Cli {
         /**
          * @brief Handle a new incoming data byte.
          *
+         * The byte is dropped while a task command is running, see isBusy().
+         * A bell is sent and the byte is counted, see getTaskDrops(). Use
+         * loop() or the bulk read() to keep the input until the task has
+         * finished.
+         *
          * @return  Zero if no comamnd has been recognized.
          *          INT8_MIN in case of an parsing related error.
          *          The return code of the command which has been recognized,
@@ -98,15 +210,64 @@ class Cli {
          */
         int8_t read(char byte);
 
+        /**
+         * @brief Handle a block of incoming data bytes.
+         *
+         * Behaves as if read(char) would have been called for every byte, but
+         * a run of printable characters is copied to the internal buffer at
+         * once and echoed by a single write to the stream.
+         *
+         * Processing stops right after a command has been executed, so the
+         * caller gets the return code of every command. Bytes which have not
+         * been consumed shall be passed in again by the next call. Nothing is
+         * consumed while a task command is running, see isBusy().
+         *
+         * @param data  Pointer to the data to process.
+         * @param len   The number of bytes to process.
+         * @param pRet  Optional, receives the same return code as read(char)
+         *              for the last processed byte.
+         *
+         * @return  The number of bytes consumed.
+         */
+        size_t read(const char *data, size_t len, int8_t *pRet = nullptr);
+
+        /**
+         * @brief Execute a complete command line.
+         *
+         * Intended for a host application which sends complete lines. The
+         * line is parsed by the same rules as typed input and the command is
+         * dispatched directly, without echo, escape sequence handling,
+         * history and prompt. Error messages are written as usual. A task
+         * command is run to completion. The input typed so far is not
+         * affected.
+         *
+         * May be called from within a command. Each nested call takes
+         * CLI_COMMANDSIZ bytes for the copy of the line and its own argument
+         * array on the stack, the arguments of the calling command stay
+         * valid.
+         *
+         * @param line  The command line, does not need to be null terminated.
+         *              A trailing line terminator is ignored.
+         * @param len   The length of the line.
+         *
+         * @return  Zero for an empty or whitespace-only line.
+         *          INT8_MIN in case of an parsing related error or if the line
+         *          is longer than CLI_COMMANDSIZ - 1.
+         *          The return code of the command otherwise.
+         */
+        int8_t execLine(const char *line, size_t len);
+
         /**
          * @brief Turn per-character echo of user input either on or off.
          *
          * When disabled, characters typed by the user (including backspace
-         * and tab-completion) are no longer echoed back automatically. This
-         * does NOT suppress everything: prompts, the bell signal, error
+         * and tab-completion) are no longer echoed back automatically, and a
+         * line recalled from the history by Arrow Up or Down is not written.
+         * This does NOT suppress everything: prompts, the bell signal, error
          * messages and the tab-completion match list are always written by
          * the library regardless of this setting, as they originate from
-         * the library itself rather than being an echo of user input.
+         * the library itself rather than being an echo of user input. Ctrl+L
+         * and the reverse history search still print the current line.
          * Intended for a host application that drives the CLI
          * programmatically and handles its own echo.
          *
@@ -156,8 +317,229 @@ class Cli {
          */
         void reset(void);
 
+        /**
+         * @brief Used to set all members of the session except the stream
+         * and the history to their initial value, see Cli() and end().
+         */
+        void init(void);
+
+#if CLI_HISTORYSIZ > 0 && CLI_HISTORY_JOURNAL != 0
+        /**
+         * @brief Used to make the command history persistent.
+         *
+         * The history is restored from the given journal and all further
+         * commands are appended to it. Should be called once after begin(),
+         * with CLI_HISTORY_SHARED on a single session only.
+         *
+         * @param pJournal The journal to use, nullptr to stop using it.
+         *
+         * @return The number of restored history lines.
+         */
+        size_t setJournal(CliJournal *pJournal);
+#endif
+
+#if CLI_CMD_TASKS != 0
+        /**
+         * @brief Used to check if a task command is running, see
+         * CLI_COMMAND_TASK().
+         *
+         * @return true if the task has not finished yet.
+         */
+        bool isBusy(void);
+
+        /**
+         * @brief Used to get the number of bytes passed to read(char) and
+         * dropped as a task command was running.
+         */
+        uint32_t getTaskDrops(void);
+#endif
+
+#if CLI_TXBUFSIZ > 0
+        /**
+         * @brief Used to get the counters of the output staging buffer.
+         *
+         * @return A copy of the current counters.
+         */
+        cliTxStats_t getTxStats(void);
+#endif
+
+        /**
+         * @brief Used to check if loop() has something to do, so the
+         * application can sleep otherwise.
+         *
+         * This is the case if input is available on the stream or in the
+         * receive ring, a received chunk has not been processed completely, a
+         * task command is running or output is queued by CLI_TX_NONBLOCK. A
+         * partially received escape sequence or line is no pending work, it
+         * waits for further input.
+         *
+         * @return true if loop() should be called.
+         */
+        bool hasPendingWork(void);
+
+#if CLI_WAKEUP != 0
+        /**
+         * @brief Used to set the function called by notify(), e.g. to give a
+         * semaphore or to set an event flag the application sleeps on. Has
+         * to be set before any other context may call notify().
+         *
+         * @param pFunc The function to call, nullptr for none.
+         * @param pArg  Passed to the function.
+         */
+        void setWakeup(CliWakeupPtr pFunc, void *pArg = nullptr);
+
+        /**
+         * @brief Used to signal that there is new work for loop(), e.g. from
+         * a receive interrupt. Calls the function set by setWakeup(), in the
+         * context of the caller.
+         */
+        inline void notify(void) {
+            if (pWakeup != nullptr) {
+                pWakeup(pWakeupArg);
+            }
+        }
+#endif
+
+#if CLI_RXRINGSIZ > 0
+        /**
+         * @brief Used to add a received byte to the receive ring of this
+         * session, which is processed by the next calls of loop().
+         *
+         * This is the only method of this class which may be called from
+         * another context, e.g. a UART interrupt or the second core, while
+         * loop() is running. There must be only one such producer per
+         * session.
+         *
+         * @param byte The received byte.
+         *
+         * @return false if the ring is full and the byte has been dropped.
+         */
+        inline bool pushFromIsr(char byte) {
+            bool ret = RxRing.push(byte);
+#if CLI_WAKEUP != 0
+            notify();
+#endif
+            return ret;
+        }
+
+        /**
+         * @brief Same as pushFromIsr() but for a block of received bytes, e.g.
+         * from a DMA buffer. What does not fit in the ring is dropped.
+         *
+         * @param data  Pointer to the received bytes.
+         * @param len   The number of bytes.
+         *
+         * @return The number of bytes added to the ring.
+         */
+        inline size_t push(const char *data, size_t len) {
+            size_t ret = RxRing.push(data, len);
+#if CLI_WAKEUP != 0
+            notify();
+#endif
+            return ret;
+        }
+
+        /**
+         * @brief Used to get the number of received bytes dropped as the
+         * receive ring was full.
+         */
+        inline uint32_t getRxOverflows(void) {
+            return RxRing.getOverflows();
+        }
+#endif
+
     private:
 
+#if CLI_RXRINGSIZ > 0
+        /**
+         * @brief Used by loop() to process the bytes in the receive ring.
+         * They are passed to read() where they are in the ring, so they are
+         * never copied.
+         *
+         * @param pRet  Set to the return code of an executed command.
+         *
+         * @return false if the ring is empty.
+         */
+        bool readRing(int8_t *pRet);
+#endif
+
+        /**
+         * @brief Used to process a block of incoming data bytes, see
+         * read(const char *, size_t, int8_t *).
+         *
+         * @param data  Pointer to the data to process.
+         * @param len   The number of bytes to process.
+         * @param pRet  Optional, receives the return code of the last byte.
+         * @param pCmd  Optional, set to true if processing stopped as a
+         *              command has been executed.
+         *
+         * @return  The number of bytes consumed.
+         */
+        size_t readInput(const char *data, size_t len, int8_t *pRet,
+                         bool *pCmd);
+
+        /**
+         * @brief Used to insert data at the cursor. Only the inserted data
+         * and the part of the line behind it are written to the terminal.
+         *
+         * @param data  The data to insert.
+         * @param len   The length of the data, must fit into the buffer.
+         */
+        void insert(const char *data, uint8_t len);
+
+        /**
+         * @brief Used to remove a part of the line before or at the cursor.
+         * The cursor is moved to the start of the removed part and only the
+         * part of the line behind it is redrawn.
+         *
+         * @param pos   The start of the part to remove, <= CurIdx.
+         * @param len   The length of the part to remove.
+         */
+        void erase(uint8_t pos, uint8_t len);
+
+        /**
+         * @brief Used to move the cursor to the given position in the line.
+         * Uses the shortest of backspaces, rewriting the line or a CUB or CUF
+         * sequence.
+         *
+         * @param pos   The new position, <= BufIdx.
+         */
+        void moveCursor(uint8_t pos);
+
+        /**
+         * @brief Used to write the sequence which moves the terminal cursor
+         * back by the given number of columns.
+         */
+        void cursorBack(uint8_t cnt);
+
+        /**
+         * @brief Used to handle the final byte of a CSI or SS3 sequence.
+         */
+        void handleCsi(char byte);
+
+        /**
+         * @brief Used to show the new content of the buffer in place of the
+         * old one, which is still shown on the terminal. Only the part behind
+         * the common part is written, followed by an erase to the end of the
+         * line if the old content was longer. The cursor is moved to the end.
+         * Nothing is written if echo is disabled, see setEcho().
+         *
+         * @param common    The length of the part the old and the new content
+         *                  have in common.
+         * @param oldLen    The length of the old content.
+         */
+        void redrawLine(uint8_t common, uint8_t oldLen);
+
+#if CLI_HISTORYSIZ > 0
+        /**
+         * @brief Used to replace the buffer content by the line at the history
+         * cursor, see redrawLine().
+         *
+         * @return false if there is no line or it does not fit.
+         */
+        bool recallLine(void);
+#endif
+
         /**
          * @brief Used to restore the previous command in the users terminal.
          *
@@ -175,7 +557,8 @@ class Cli {
         bool restoreNextCmd(void);
 
         /**
-         * @brief Used to step through the command table.
+         * @brief Used to add the command in the input buffer to the history,
+         * to execute it by dispatch() and to print a new prompt.
          *
          * @return  Zero if no comamnd has been recognized.
          *          INT8_MIN in case of an parsing related error.
@@ -185,36 +568,62 @@ class Cli {
         int8_t checkCmdTable(void);
 
         /**
-         * @brief Used to check whether a specific command's name matches the
-         * current input buffer. Does not touch Buffer, Argv or Argc, on a
-         * match call parseArgs() to parse the arguments.
+         * @brief Used to look up the command in the given line and to
+         * execute it. The lookup is done by CliCommand::find(). Prints an
+         * error message if the command fails.
          *
-         * @param pCmd      Pointer to a command defintion
+         * @param buf   The null terminated command line, modified by
+         *              parseArgs().
+         * @param defer true to start a task command, to be continued by
+         *              loop(). false to run it to completion.
          *
-         * @return true     In case of a name match.
-         * @return false    In case of a mismatch.
+         * @return  INT8_MIN in case of an parsing related error.
+         *          The return code of the command otherwise, CLI_CMD_BUSY if
+         *          a task command has been started.
          */
-        bool checkCmd(cliCmd_t *pCmd);
+        int8_t dispatch(char *buf, bool defer);
 
         /**
          * @brief Used to parse the arguments following a matched command
-         * name into Argv/Argc. Destructively modifies Buffer in place.
+         * name into args. Destructively modifies buf in place in a
+         * single pass, so the parsing time is linear in the input length.
          *
          * On failure a specific error message has already been printed to
          * the stream, the caller shall not print an additional one.
          *
-         * @param startIdx  Index in Buffer where the arguments begin, i.e.
+         * @param buf       The null terminated command line.
+         * @param startIdx  Index in buf where the arguments begin, i.e.
          *                  the length of the matched command name.
+         * @param args      Receives the arguments, pointing into buf.
          *
          * @return true     In case of sucessful parsing.
          * @return false    In case of a parsing error.
          */
-        bool parseArgs(uint8_t startIdx);
+        bool parseArgs(char *buf, uint8_t startIdx, cliArgs_t &args);
+
+#if CLI_CMD_TASKS != 0
+        /**
+         * @brief Used to call the running task command once.
+         *
+         * @return The return code of the task, CLI_CMD_BUSY if it has not
+         * finished yet.
+         */
+        int8_t runTask(void);
+#endif
 
         /**
-         * @brief Used reset argc and argv
+         * @brief Used to check if a byte is a printable character. Those are
+         * never handled as special case by read(char) as long as no escape
+         * sequence is pending.
+         *
+         * @param byte  The byte to check.
+         *
+         * @return true     If the byte is a printable character.
+         * @return false    Otherwise.
          */
-        void argReset(void);
+        static inline bool isPlain(char byte) {
+            return (byte >= 0x20) && (byte < 0x7f);
+        }
 
         /**
          * @brief Handle tab completion for commands.
@@ -226,14 +635,124 @@ class Cli {
          */
         void handleTabCompletion(void);
 
+#if CLI_HISTORYSIZ > 0 && CLI_HISTORY_SEARCH > 0
         /**
-         * @brief Find all commands in the command table matching the current 
-         * buffer content.
-         * 
-         * @param matches Array to store pointers to matching command names
-         * @return Number of matches found
+         * @brief Start the reverse incremental history search, see
+         * CLI_HISTORY_SEARCH.
          */
-        uint8_t findMatchingCommands(const char* matches[]);
+        void startSearch(void);
+
+        /**
+         * @brief Handle a received byte while the history search is active.
+         *
+         * Printable characters refine the search pattern, backspace shortens
+         * it, ctrl-R searches for the next older match and ctrl-G cancels the
+         * search. Any other byte accepts the current match into the buffer.
+         *
+         * @param byte  The received byte.
+         *
+         * @return true     If the byte has been consumed.
+         * @return false    If the search has ended and the byte has to be
+         *                  processed as usual.
+         */
+        bool handleSearch(char byte);
+
+        /**
+         * @brief Redraw the search line showing the pattern and the current
+         * match.
+         */
+        void drawSearch(void);
+#endif
+
+#if CLI_FRAMED != 0
+        /**
+         * @brief Handle a received byte while a request frame is received,
+         * see CLI_FRAMED.
+         *
+         * @param byte  The received byte.
+         * @param ret   Set to the return code of the command if the frame is
+         *              complete.
+         *
+         * @return true     If the byte has been consumed.
+         * @return false    If the byte following DLE was not STX, so it is no
+         *                  frame and the byte has to be processed as usual.
+         */
+        bool handleFrame(char byte, int8_t &ret);
+
+        /**
+         * @brief Used to drop a partial request frame if the time since its
+         * last byte exceeds CLI_FRAME_TIMEOUT.
+         */
+        void expireFrame(void);
+
+        /**
+         * @brief Used to drop a partial request frame. A DLE which has not
+         * been followed by STX yet is stored as ordinary input, like it is
+         * without CLI_FRAMED.
+         */
+        void dropFrame(void);
+
+        /**
+         * @brief Used to receive a block of the command line of a request
+         * frame. A command line never contains DLE, a DLE drops the partial
+         * frame and may start a new one.
+         *
+         * @param data  Pointer to the received bytes.
+         * @param len   The number of received bytes.
+         *
+         * @return The number of bytes consumed, at most the number of bytes
+         * which are still missing.
+         */
+        size_t frameData(const char *data, size_t len);
+
+        /**
+         * @brief Used to execute the command line of a received request frame
+         * and to send the response frame.
+         *
+         * @param valid false if the CRC of the request frame was wrong.
+         *
+         * @return The return code of the command, INT8_MIN if it has not been
+         * executed.
+         */
+        int8_t execFrame(bool valid);
+#endif
+
+        /**
+         * @brief Used to check if a request frame is received.
+         */
+        inline bool isFraming(void) {
+#if CLI_FRAMED != 0
+            return FrameState != frame_idle;
+#else
+            return false;
+#endif
+        }
+
+        /**
+         * @brief Used to check if the history search is active.
+         */
+        inline bool isSearching(void) {
+#if CLI_HISTORYSIZ > 0 && CLI_HISTORY_SEARCH > 0
+            return Searching;
+#else
+            return false;
+#endif
+        }
+
+        /**
+         * @brief Used to determine the table the last token of the input is
+         * completed from. This is the command table or, if subcommands are
+         * enabled and the input starts with groups, the table of the last
+         * group.
+         *
+         * @param pTab  Set to the table.
+         * @param cnt   Set to the number of entries of the table.
+         * @param start Set to the index of the last token in the buffer.
+         *
+         * @return false if one of the leading tokens is not a group.
+         */
+        bool completionLevel(const cliCmd_t*& pTab, size_t& cnt,
+                             uint8_t& start);
 
         /**
          * @brief Complete a portion of a match.
@@ -242,7 +761,8 @@ class Cli {
          * portion of the match to the terminal.
          * 
          * @param match The command name to complete
-         * @param len The length of the portion to complete
+         * @param len The length of the portion to complete, starting at
+         *            TabStart
          * @param addSpace Whether to add a space after completion (true for
          *                 complete matches, false for partial/common prefix)
          */
@@ -252,20 +772,98 @@ class Cli {
          * @brief Compleate to the longest common prefix among multiple matches.
          * 
          * This function completes the command buffer to the longest common 
-         * prefix among the given matches.
+         * prefix among the given matches. If the matches are a range of the
+         * sorted command table, this is the common prefix of the first and the
+         * last match.
          * 
-         * @param matches Array of matching command names
-         * @param matchCount Number of matches in the array
+         * @param first Index of the first match in the completed table
+         * @param matchCount Number of matches
          */
-        void completeToCommonPrefix(const char* matches[], uint8_t matchCount);
+        void completeToCommonPrefix(size_t first, size_t matchCount);
 
         /**
          * @brief Display a list of matching commands with line wrapping.
          * 
-         * @param matches Array of matching command names
+         * @param first Index of the first match in the completed table
          * @param matchCount Number of matches to display
          */
-        void displayMatchList(const char* matches[], uint8_t matchCount);
+        void displayMatchList(size_t first, size_t matchCount);
+
+        /**
+         * @brief Used to get a match of the last completion.
+         *
+         * The matches are a range of a sorted table. If the command table is
+         * not sorted, see CliCommand::isSorted(), the matches are the entries
+         * from the first one on which share the first TabLen - TabStart
+         * characters with it.
+         *
+         * @param first Index of the first match in the completed table
+         * @param n     Number of the match, starting at 0
+         */
+        const cliCmd_t* tabMatch(size_t first, size_t n);
+
+#if CLI_TAB_CYCLE != 0
+        /**
+         * @brief Replace the buffer content from TabStart on by the given
+         * string. Only the part which differs from the current content is
+         * rewritten on the terminal.
+         *
+         * @param str The new buffer content
+         * @param len The length of the new content
+         */
+        void replaceSuffix(const char* str, uint8_t len);
+#endif
+
+        /**
+         * @brief Used to write output to the stream. While input is processed
+         * the output is collected in the staging buffer if CLI_TXBUFSIZ is
+         * not zero, otherwise it is written directly.
+         *
+         * @param data  Pointer to the data to write.
+         * @param len   The number of bytes to write.
+         */
+        void txWrite(const char *data, size_t len);
+
+        /**
+         * @brief Used to write a null terminated string, see above.
+         */
+        void txWrite(const char *str);
+
+        /**
+         * @brief Used to write a single byte, see above.
+         */
+        void txWrite(char byte);
+
+        /**
+         * @brief Used to write a short formatted message, see above. The
+         * message is truncated to 47 characters.
+         */
+        void txPrintf(const char *fmt, ...) 
+            __attribute__ ((format (printf, 2, 3)));
+
+        /**
+         * @brief Used to write all collected output to the stream. If
+         * CLI_TX_NONBLOCK is enabled only as much as the stream is able to
+         * take without blocking, the rest is kept.
+         */
+        void txFlush(void);
+
+        /**
+         * @brief Used to write all collected output to the stream, even if
+         * this blocks.
+         */
+        void txDrain(void);
+
+        /**
+         * @brief Used to hold back output until the current input event has
+         * been processed. 
+         *
+         * @param hold  true to collect output, false to flush collected 
+         *              output and write further output directly.
+         *
+         * @return The previous state, to be restored by the caller.
+         */
+        bool txHold(bool hold);
 
         /**
          * @brief The stream object to use for io operations.
@@ -279,7 +877,7 @@ class Cli {
          * esc_true is used if a escape character has ben detected.
          * esc_csi is used when a escape has been followed by a csi character.
          */
-        enum
+        enum : uint8_t
         {
             esc_false = 0,
             esc_true = 1,
@@ -287,13 +885,123 @@ class Cli {
         }
         EscMode;
 
+        /**
+         * @brief The numeric parameter of the current CSI sequence, e.g. 3
+         * for the Delete key. UINT8_MAX if there is more than one parameter.
+         */
+        uint8_t EscParam;
+
 #if CLI_HISTORYSIZ > 0
         /**
-         * @brief The command history buffer instance
+         * @brief The command history buffer instance, shared by all instances
+         * of this class if CLI_HISTORY_SHARED is enabled.
          */
+#if CLI_HISTORY_SHARED != 0
+        static CliHistory History;
+#else
         CliHistory History;
 #endif
 
+        /**
+         * @brief The history navigation state of this instance.
+         */
+        CliHistory::cursor_t HistCur;
+
+#if CLI_HISTORY_SEARCH > 0
+        /**
+         * @brief The pattern of the history search.
+         */
+        char Search[CLI_HISTORY_SEARCH];
+
+        /**
+         * @brief The length of the history search pattern.
+         */
+        uint8_t SearchLen;
+
+        /**
+         * @brief Used to indicate that the history search is active.
+         */
+        bool Searching;
+
+        /**
+         * @brief Used to indicate that HistCur refers to a matching line.
+         */
+        bool SearchHit;
+
+        /**
+         * @brief Used to indicate that the current pattern has not been found,
+         * HistCur still refers to the last match.
+         */
+        bool SearchFailed;
+#endif
+#endif
+
+#if CLI_FRAMED != 0
+        /**
+         * @brief Used to represent the states of receiving a request frame.
+         */
+        enum : uint8_t
+        {
+            frame_idle = 0,
+            frame_start,
+            frame_seq,
+            frame_len,
+            frame_data,
+            frame_crc_hi,
+            frame_crc_lo
+        }
+        FrameState;
+
+        /**
+         * @brief The command line of the request frame.
+         */
+        char FrameBuf[CLI_COMMANDSIZ];
+
+        /**
+         * @brief The number of command line bytes received so far.
+         */
+        uint8_t FrameIdx;
+
+        /**
+         * @brief The length of the command line of the request frame.
+         */
+        uint8_t FrameLen;
+
+        /**
+         * @brief The sequence number of the request frame.
+         */
+        uint8_t FrameSeq;
+
+        /**
+         * @brief The CRC of the request frame received so far.
+         */
+        uint16_t FrameCrc;
+
+        /**
+         * @brief The time of the last byte of the request frame in ms, see
+         * CLI_FRAME_TIMEOUT.
+         */
+        uint32_t FrameTime;
+#endif
+
+#if CLI_RXCHUNKSIZ > 0
+        /**
+         * @brief Chunk of data fetched from the stream by loop() but not yet
+         * processed.
+         */
+        char RxBuf[CLI_RXCHUNKSIZ];
+
+        /**
+         * @brief Read position in RxBuf.
+         */
+        uint8_t RxPos;
+
+        /**
+         * @brief Number of valid bytes in RxBuf.
+         */
+        uint8_t RxLen;
+#endif
+
         /**
          * @brief The internal buffer.
          */
@@ -305,36 +1013,142 @@ class Cli {
         uint8_t BufIdx;
 
         /**
-         * @brief The argument filed to be passed to called user functins.
-         *
-         * Limitation: dont want to use malloc, so define the size statically.
-         * This means that the maximum number of arguments is limited, thats OK
-         * for now.
+         * @brief The position of the cursor in the internal buffer, input is
+         * inserted here. Equal to BufIdx if the cursor is at the end.
          */
-        char *Argv[CLI_ARGVSIZ];
+        uint8_t CurIdx;
 
+#if CLI_CMD_TASKS != 0
         /**
-         * @brief States if the particular argument is a sting or not.
+         * @brief The command table entry of the running task command, nullptr
+         * if there is none.
          */
-        bool StringArg[CLI_ARGVSIZ];
+        const cliCmd_t *pTask;
 
         /**
-         * @brief The number of detected arguments.
+         * @brief The state of the running task command.
          */
-        uint8_t Argc;
+        cliTaskCtx_t TaskCtx;
 
         /**
-         * @brief Pointer to a array of user commands.
+         * @brief The arguments of the running task command. The arguments
+         * parsed by dispatch() only live during the first call.
          */
-        cliCmd_t* pCmdTab;
+        const char *TaskArgv[CLI_ARGVSIZ];
 
         /**
-         * @brief Size of the command array.
+         * @brief The number of arguments of the running task command.
          */
-        uint8_t CmdTabSiz;
+        uint8_t TaskArgc;
+
+        /**
+         * @brief The number of bytes dropped by read(char) while a task
+         * command was running.
+         */
+        uint32_t TaskDrops;
+#endif
 
         /**
          * @brief The current per-character input echo state, see setEcho().
          */
         bool EchoEnabled;
+
+        /**
+         * @brief States if output is held back, see txHold().
+         */
+        bool TxHold;
+
+#if CLI_TAB_COMPLETION != 0
+        /**
+         * @brief The table the last completion has been done from, see
+         * completionLevel().
+         */
+        const cliCmd_t *pTabCmds;
+
+        /**
+         * @brief Index of the token in the buffer the last completion has
+         * been done for.
+         */
+        uint8_t TabStart;
+
+        /**
+         * @brief Index of the first command matching the last completed
+         * prefix.
+         */
+        size_t TabFirst;
+
+        /**
+         * @brief Number of commands matching the last completed prefix. Zero
+         * if there is no previous result to narrow.
+         */
+        size_t TabCnt;
+
+        /**
+         * @brief Length of the last completed prefix.
+         */
+        uint8_t TabLen;
+
+        /**
+         * @brief Set by a tab which listed the matches, cleared by any other
+         * input. So a further tab knows that nothing has changed meanwhile.
+         */
+        bool TabRepeat;
+
+#if CLI_TAB_CYCLE != 0
+        /**
+         * @brief The match shown while cycling, relative to TabFirst. Equal to
+         * TabCnt if the common prefix is shown.
+         */
+        size_t TabCur;
+
+        /**
+         * @brief The length of the common prefix of the matches.
+         */
+        uint8_t TabBase;
+#endif
+#endif
+
+#if CLI_TXBUFSIZ > 0
+        /**
+         * @brief The output staging buffer.
+         */
+        char TxBuf[CLI_TXBUFSIZ];
+
+        /**
+         * @brief The number of bytes in the output staging buffer.
+         */
+        uint16_t TxLen;
+
+#if CLI_TX_NONBLOCK != 0
+        /**
+         * @brief The position of the first byte in the output staging buffer
+         * which has not been written yet.
+         */
+        uint16_t TxPos;
+#endif
+
+        /**
+         * @brief The output staging buffer counters, see getTxStats().
+         */
+        cliTxStats_t TxStats;
+#endif
+
+#if CLI_RXRINGSIZ > 0
+        /**
+         * @brief The receive ring, see pushFromIsr().
+         */
+        CliRxRing RxRing;
+#endif
+
+#if CLI_WAKEUP != 0
+        /**
+         * @brief The function called by notify().
+         */
+        CliWakeupPtr pWakeup;
+
+        /**
+         * @brief The argument of the wakeup function.
+         */
+        void *pWakeupArg;
+#endif
 };
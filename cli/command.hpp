@@ -37,6 +37,36 @@
                                                                     \
     int8_t cmd_ ## _name (Stream& ioStream, const char *argv[], uint8_t argc)
 
+#if CLI_CMD_TASKS != 0
+/**
+ * @brief Generates a libcli task command definition based on the given name.
+ */
+#define CLI_COMMAND_TASK_DEF(_name)                                 \
+                                                                    \
+    int8_t task_ ## _name (Stream& ioStream, const char *argv[],    \
+        uint8_t argc, cliTaskCtx_t& ctx)
+
+/**
+ * @brief Used to initialize the task function of a command table entry. Can
+ * be used regardless of CLI_CMD_TASKS, so every entry initializes all members.
+ */
+#define CLI_ENTRY_TASK(_task)       , _task
+#else
+#define CLI_ENTRY_TASK(_task)
+#endif
+
+#if CLI_SUBCOMMANDS != 0
+/**
+ * @brief Used to initialize the subcommands of a command table entry. Can be
+ * used regardless of CLI_SUBCOMMANDS, see CLI_ENTRY_TASK().
+ */
+#define CLI_ENTRY_SUB(_pSub)        , _pSub
+#else
+#define CLI_ENTRY_SUB(_pSub)
+#endif
+
+#if CLI_CMDTAB_STATIC == 0
+
 /**
  * @brief Used to define and register a libcli command.
  */
@@ -46,12 +76,250 @@
     static CliCommand _name ## _registrar(#_name, cmd_ ## _name);   \
     CLI_COMMAND_DEF(_name)
 
+#if CLI_CMD_TASKS != 0
+/**
+ * @brief Used to define and register a libcli task command, which returns
+ * CLI_CMD_BUSY as long as it has not finished yet.
+ */
+#define CLI_COMMAND_TASK(_name)                                     \
+                                                                    \
+    CLI_COMMAND_TASK_DEF(_name);                                    \
+    static CliCommand _name ## _registrar(#_name, task_ ## _name);  \
+    CLI_COMMAND_TASK_DEF(_name)
+#endif
+
+/**
+ * @brief Used to register a further name for an existing command. The alias
+ * shares the function of the command, which has to be declared before, e.g.
+ * by CLI_COMMAND() or CLI_COMMAND_DEF().
+ */
+#define CLI_ALIAS(_alias, _name)                                    \
+                                                                    \
+    static CliCommand _alias ## _registrar(#_alias, cmd_ ## _name)
+
+#else
+
+/**
+ * @brief Used to define a libcli command. It has to be listed in the command
+ * table defined by CLI_COMMAND_TABLE().
+ */
+#define CLI_COMMAND(_name)                                          \
+                                                                    \
+    CLI_COMMAND_DEF(_name)
+
+/**
+ * @brief Used to create a entry of the command table defined by
+ * CLI_COMMAND_TABLE(). The command function has to be declared before, e.g.
+ * by CLI_COMMAND_DEF(_name).
+ */
+#define CLI_COMMAND_ENTRY(_name)                                    \
+                                                                    \
+    { #_name, cmd_ ## _name CLI_ENTRY_TASK(nullptr) CLI_ENTRY_SUB(nullptr) }
+
+/**
+ * @brief Used to create a entry of the command table for a further name of
+ * an existing command. The alias shares the function of the command and is
+ * sorted by its own name.
+ */
+#define CLI_ALIAS_ENTRY(_alias, _name)                              \
+                                                                    \
+    { #_alias, cmd_ ## _name CLI_ENTRY_TASK(nullptr) CLI_ENTRY_SUB(nullptr) }
+
+#if CLI_CMD_TASKS != 0
+/**
+ * @brief Used to define a libcli task command. It has to be listed in the
+ * command table by CLI_COMMAND_TASK_ENTRY().
+ */
+#define CLI_COMMAND_TASK(_name)                                     \
+                                                                    \
+    CLI_COMMAND_TASK_DEF(_name)
+
+/**
+ * @brief Used to create a entry of the command table for a task command, see
+ * CLI_COMMAND_ENTRY().
+ */
+#define CLI_COMMAND_TASK_ENTRY(_name)                               \
+                                                                    \
+    { #_name, nullptr CLI_ENTRY_TASK(task_ ## _name)                \
+      CLI_ENTRY_SUB(nullptr) }
+#endif
+
+#if CLI_CMD_STATS != 0
+/**
+ * @brief Used by CLI_COMMAND_TABLE() to define the statistics of the commands
+ * in the table.
+ */
+#define CLI_COMMAND_STATS_DEF(_cnt)                                 \
+                                                                    \
+    cliCmdStats_t cliCmdStats[_cnt];
+#else
+#define CLI_COMMAND_STATS_DEF(_cnt)
+#endif
+
+/**
+ * @brief Used to define the global command table at compile time, must be
+ * used exactly once. The entries, see CLI_COMMAND_ENTRY(), must be given in
+ * alphabetical order, which is verified at compile time.
+ */
+#define CLI_COMMAND_TABLE(...)                                      \
+                                                                    \
+    extern constexpr cliCmd_t cliCmdTab[] = { __VA_ARGS__ };        \
+    extern constexpr size_t cliCmdTabCnt =                          \
+        sizeof(cliCmdTab) / sizeof(cliCmdTab[0]);                   \
+    CLI_COMMAND_STATS_DEF(sizeof(cliCmdTab) / sizeof(cliCmdTab[0])) \
+    static_assert(cliCmdTabIsSorted(cliCmdTab, cliCmdTabCnt),       \
+        "CLI_COMMAND_TABLE() entries must be sorted alphabetically")
+
+#endif
+
+#if CLI_SUBCOMMANDS != 0
+
+/**
+ * @brief Generates the definition of a subcommand of the given group. The
+ * name of a nested group is the path of names joined by '_', e.g. net_ip.
+ */
+#define CLI_SUBCOMMAND(_group, _name)                               \
+                                                                    \
+    CLI_COMMAND_DEF(_group ## _ ## _name)
+
+/**
+ * @brief Used to create a entry of the table of a group for a subcommand
+ * defined by CLI_SUBCOMMAND().
+ */
+#define CLI_SUBCOMMAND_ENTRY(_group, _name)                         \
+                                                                    \
+    { #_name, cmd_ ## _group ## _ ## _name CLI_ENTRY_TASK(nullptr)  \
+      CLI_ENTRY_SUB(nullptr) }
+
+/**
+ * @brief Used to create a entry of the table of a group for a further name
+ * of a subcommand defined by CLI_SUBCOMMAND().
+ */
+#define CLI_SUBALIAS_ENTRY(_group, _alias, _name)                   \
+                                                                    \
+    { #_alias, cmd_ ## _group ## _ ## _name CLI_ENTRY_TASK(nullptr) \
+      CLI_ENTRY_SUB(nullptr) }
+
+/**
+ * @brief Used to create a entry of the table of a group for a nested group
+ * defined by CLI_SUBGROUP(), which has to be defined before.
+ */
+#define CLI_SUBGROUP_ENTRY(_group, _name)                           \
+                                                                    \
+    { #_name, cmd_ ## _group ## _ ## _name CLI_ENTRY_TASK(nullptr)  \
+      CLI_ENTRY_SUB(&_group ## _ ## _name ## _subgroup) }
+
+/**
+ * @brief Used to define a group, i.e. its table of subcommands and the
+ * command function which dispatches to them. The entries, see
+ * CLI_SUBCOMMAND_ENTRY() and CLI_SUBGROUP_ENTRY(), must be given in
+ * alphabetical order, which is verified at compile time.
+ */
+#define CLI_SUBGROUP(_group, ...)                                   \
+                                                                    \
+    static constexpr cliCmd_t _group ## _subtab[] = { __VA_ARGS__ };\
+    extern constexpr cliCmdGroup_t _group ## _subgroup = {          \
+        _group ## _subtab,                                          \
+        sizeof(_group ## _subtab) / sizeof(_group ## _subtab[0]) }; \
+    CLI_COMMAND_DEF(_group) {                                       \
+        return CliCommand::dispatchSub(_group ## _subgroup,         \
+            ioStream, argv, argc);                                  \
+    }                                                               \
+    static_assert(cliCmdTabIsSorted(_group ## _subtab,              \
+            _group ## _subgroup.cnt),                               \
+        "CLI_SUBGROUP() entries must be sorted alphabetically")
+
+/**
+ * @brief Used to declare a group defined in another file, so it can be
+ * listed by CLI_COMMAND_GROUP_ENTRY() or CLI_SUBGROUP_ENTRY().
+ */
+#define CLI_SUBGROUP_DEF(_group)                                    \
+                                                                    \
+    extern const cliCmdGroup_t _group ## _subgroup;                 \
+    CLI_COMMAND_DEF(_group)
+
+#if CLI_CMDTAB_STATIC == 0
+/**
+ * @brief Used to define and register a top level group, see CLI_SUBGROUP().
+ */
+#define CLI_COMMAND_GROUP(_name, ...)                               \
+                                                                    \
+    CLI_SUBGROUP(_name, __VA_ARGS__);                               \
+    static CliCommand _name ## _registrar(#_name, cmd_ ## _name,    \
+        &_name ## _subgroup)
+#else
+/**
+ * @brief Used to define a top level group, see CLI_SUBGROUP(). It has to be
+ * listed in the command table by CLI_COMMAND_GROUP_ENTRY().
+ */
+#define CLI_COMMAND_GROUP(_name, ...)                               \
+                                                                    \
+    CLI_SUBGROUP(_name, __VA_ARGS__)
+
+/**
+ * @brief Used to create a entry of the command table for a group defined by
+ * CLI_COMMAND_GROUP().
+ */
+#define CLI_COMMAND_GROUP_ENTRY(_name)                              \
+                                                                    \
+    { #_name, cmd_ ## _name CLI_ENTRY_TASK(nullptr)                 \
+      CLI_ENTRY_SUB(&_name ## _subgroup) }
+#endif
+
+#endif /* CLI_SUBCOMMANDS != 0 */
+
 /**
  * @brief Defines a libcli command function pointer.
  */
 typedef int8_t (*CmdFuncPtr)(Stream& ioStream, const char *argv[],
     uint8_t argc);
 
+#if CLI_CMD_TASKS != 0
+
+/**
+ * @brief The return code of a task command which has not finished yet. It is
+ * called again by Cli::loop() later on.
+ */
+#define CLI_CMD_BUSY                INT8_MAX
+
+/**
+ * @brief The state of a running task command, kept by the session from the
+ * first call until the task has finished.
+ */
+typedef struct {
+
+    /**
+     * @brief Number of previous calls, zero on the first call.
+     */
+    uint32_t call;
+
+    /**
+     * @brief Free for use by the task, zero on the first call.
+     */
+    uint32_t state;
+
+    /**
+     * @brief Free for use by the task, nullptr on the first call.
+     */
+    void *pData;
+
+} cliTaskCtx_t;
+
+/**
+ * @brief Defines a libcli task command function pointer.
+ */
+typedef int8_t (*CmdTaskPtr)(Stream& ioStream, const char *argv[],
+    uint8_t argc, cliTaskCtx_t& ctx);
+
+#endif
+
+#if CLI_SUBCOMMANDS != 0
+/**
+ * @brief The table of subcommands of a group, see CLI_SUBGROUP().
+ */
+typedef struct cliCmdGroup cliCmdGroup_t;
+#endif
+
 /**
  * @brief The command structure used to store the command name and the
  * corresponding function pointer.
@@ -64,12 +332,130 @@ typedef struct {
     const char *name;
 
     /**
-     * @brief Pointer to the command function.
+     * @brief Pointer to the command function, nullptr for a task command.
      */
     CmdFuncPtr pfunc;
 
+#if CLI_CMD_TASKS != 0
+    /**
+     * @brief Pointer to the task function, nullptr for a ordinary command.
+     */
+    CmdTaskPtr ptask;
+#endif
+
+#if CLI_SUBCOMMANDS != 0
+    /**
+     * @brief Pointer to the subcommands of a group, nullptr for a command.
+     */
+    const cliCmdGroup_t *pSub;
+#endif
+
 } cliCmd_t;
 
+#if CLI_SUBCOMMANDS != 0
+struct cliCmdGroup {
+
+    /**
+     * @brief The sorted table of subcommands.
+     */
+    const cliCmd_t *pTab;
+
+    /**
+     * @brief The number of subcommands.
+     */
+    size_t cnt;
+
+};
+#endif
+
+#if CLI_CMD_STATS != 0
+
+/**
+ * @brief The execution statistics of a command, see CLI_CMD_STATS. All times
+ * are given in ticks of CLI_CMD_STATS_TIMER(), microseconds by default.
+ */
+typedef struct {
+
+    /**
+     * @brief Number of calls.
+     */
+    uint32_t calls;
+
+    /**
+     * @brief Number of calls which returned a non-zero value.
+     */
+    uint32_t fails;
+
+    /**
+     * @brief Total execution time of all calls.
+     */
+    uint32_t total;
+
+    /**
+     * @brief Maximum execution time of a single call.
+     */
+    uint32_t max;
+
+    /**
+     * @brief Execution time of the last call.
+     */
+    uint32_t last;
+
+} cliCmdStats_t;
+
+#if CLI_CMD_STATS_COMMAND != 0
+/**
+ * @brief The built-in command to print the statistics. Has to be listed in
+ * CLI_COMMAND_TABLE() if CLI_CMDTAB_STATIC is enabled.
+ */
+CLI_COMMAND_DEF(cmdstat);
+#endif
+
+#endif
+
+#if CLI_CMDTAB_STATIC != 0
+
+/**
+ * @brief The global command table defined by CLI_COMMAND_TABLE().
+ */
+extern const cliCmd_t cliCmdTab[];
+
+/**
+ * @brief The number of entries in the global command table.
+ */
+extern const size_t cliCmdTabCnt;
+
+#if CLI_CMD_STATS != 0
+/**
+ * @brief The statistics of the entries in the global command table.
+ */
+extern cliCmdStats_t cliCmdStats[];
+#endif
+
+#endif
+
+/**
+ * @brief Compile time version of strcmp(), used to verify the order of the
+ * command table.
+ */
+constexpr int cliStrCmp(const char *a, const char *b) {
+    return (*a != *b || *a == '\0') ?
+        (int) (unsigned char) *a - (int) (unsigned char) *b :
+        cliStrCmp(a + 1, b + 1);
+}
+
+/**
+ * @brief Used to check at compile time if the given command table is sorted
+ * in the same order as CliCommand::sortTable() would sort it. Splits the
+ * table in halves to keep the recursion depth at O(log n).
+ */
+constexpr bool cliCmdTabIsSorted(const cliCmd_t *pTab, size_t cnt) {
+    return cnt < 2 ? true :
+        cliCmdTabIsSorted(pTab, cnt / 2) &&
+        cliStrCmp(pTab[cnt / 2 - 1].name, pTab[cnt / 2].name) <= 0 &&
+        cliCmdTabIsSorted(pTab + cnt / 2, cnt - cnt / 2);
+}
+
 /**
  * @brief The command class used to register and find commands.
  */
@@ -77,21 +463,66 @@ class CliCommand {
 
     public:
 
+#if CLI_CMDTAB_STATIC == 0
         /**
          * @brief Construct a new Command object and automatically register it
          * in the global command table.
          */
         CliCommand(const char* name, CmdFuncPtr function);
 
+#if CLI_CMD_TASKS != 0
+        /**
+         * @brief Construct a new Command object for a task command and
+         * automatically register it in the global command table.
+         */
+        CliCommand(const char* name, CmdTaskPtr task);
+#endif
+
+#if CLI_SUBCOMMANDS != 0
+        /**
+         * @brief Construct a new Command object for a group and automatically
+         * register it in the global command table.
+         */
+        CliCommand(const char* name, CmdFuncPtr function,
+            const cliCmdGroup_t* pSub);
+#endif
+#endif
+
         /**
          * @brief Used to sort the global command table alphabetically.
+         *
+         * A sorted table is used as lookup index by find(), see there. Does
+         * nothing if CLI_CMDTAB_STATIC is enabled, as the table is sorted at
+         * compile time.
          */
         static void sortTable(void);
 
+        /**
+         * @brief Used to check if the global command table is sorted.
+         *
+         * @return true if sortTable() has been called and no command has been
+         * registered afterwards.
+         */
+        static bool isSorted(void);
+
+        /**
+         * @brief Used to check if the given table is sorted. All tables except
+         * the global command table are sorted at compile time.
+         *
+         * @param pTab The table, e.g. the subcommands of a group.
+         *
+         * @return true if the table is sorted.
+         */
+        static bool isSorted(const cliCmd_t* pTab);
+
         /**
          * @brief Used to get the global command table.
          */
+#if CLI_CMDTAB_STATIC == 0
         static cliCmd_t* getTable(void);
+#else
+        static const cliCmd_t* getTable(void);
+#endif
 
         /**
          * @brief Used to get the number of registered commands.
@@ -104,15 +535,182 @@ class CliCommand {
          */
         static size_t getDropCnt(void);
 
+        /**
+         * @brief Used to find a command table entry by its name.
+         *
+         * If the table is sorted, see sortTable(), a binary search is used
+         * which takes O(log n) string compares. Otherwise the table is
+         * searched linearly.
+         *
+         * @param name  The name of the command to find, does not need to be
+         *              null terminated.
+         * @param len   The length of the name.
+         *
+         * @return Pointer to the table entry or nullptr if not found.
+         */
+        static const cliCmd_t* find(const char* name, size_t len);
+
+        /**
+         * @brief Used to find a entry of the given sorted table by its name,
+         * by a binary search.
+         *
+         * @param pTab  The sorted table.
+         * @param cnt   The number of entries in the table.
+         * @param name  The name to find, does not need to be null terminated.
+         * @param len   The length of the name.
+         *
+         * @return Pointer to the table entry or nullptr if not found.
+         */
+        static const cliCmd_t* find(const cliCmd_t* pTab, size_t cnt,
+                                    const char* name, size_t len);
+
+        /**
+         * @brief Used to find a entry of the given table by its name or, if
+         * CLI_PREFIX_MATCH is enabled, by a prefix of exactly one name. The
+         * global command table is searched linearly if it is not sorted, see
+         * isSorted().
+         *
+         * @param pTab      The table.
+         * @param cnt       The number of entries in the table.
+         * @param name      The name to find, does not need to be null
+         *                  terminated.
+         * @param len       The length of the name.
+         * @param first     Set to the index of the first matching entry.
+         * @param matches   Set to the number of matching entries, more than
+         *                  one if the prefix is ambiguous.
+         *
+         * @return Pointer to the table entry or nullptr if there is none or
+         * more than one.
+         */
+        static const cliCmd_t* resolve(const cliCmd_t* pTab, size_t cnt,
+                                       const char* name, size_t len,
+                                       size_t& first, size_t& matches);
+
+        /**
+         * @brief Used to find all command table entries whose name starts
+         * with the given prefix.
+         *
+         * In the sorted table the matching entries form one contiguous range
+         * which is found by a lower and upper bound binary search in O(log n)
+         * string compares. If the table is not sorted, see isSorted(), it is
+         * scanned linearly instead. The matches then follow the first one
+         * interleaved with other entries, so a range to narrow by the
+         * function below has to reach up to the end of the table.
+         *
+         * @param prefix    The prefix, does not need to be null terminated.
+         * @param len       The length of the prefix.
+         * @param first     Set to the index of the first matching entry.
+         *
+         * @return The number of matching entries.
+         */
+        static size_t findPrefix(const char* prefix, size_t len, size_t& first);
+
+        /**
+         * @brief Used to narrow a range of command table entries, as returned
+         * by the function above, to the entries whose name starts with the
+         * given prefix. This is used if the given prefix is an extension of
+         * the one the range has been found for.
+         *
+         * @param prefix    The prefix, does not need to be null terminated.
+         * @param len       The length of the prefix.
+         * @param first     The index of the first entry of the range, set to
+         *                  the index of the first matching entry.
+         * @param cnt       The number of entries in the range.
+         *
+         * @return The number of matching entries.
+         */
+        static size_t findPrefix(const char* prefix, size_t len, size_t& first,
+                                 size_t cnt);
+
+        /**
+         * @brief Same as above, but for a range of the given table, e.g. the
+         * subcommands of a group.
+         *
+         * @param pTab      The table.
+         */
+        static size_t findPrefix(const cliCmd_t* pTab, const char* prefix,
+                                 size_t len, size_t& first, size_t cnt);
+
         /**
          * @brief Used to find a command by its name.
          *
          * @param name The name of the command to find.
          *
-         * @return The function pointer of the command or nullptr if not found.
+         * @return The function pointer of the command or nullptr if not found
+         * or if it is a task command.
          */
         static CmdFuncPtr getCmd(const char* name);
 
+        /**
+         * @brief Used by a command to state that its input has been rejected
+         * with a specific error message, e.g. by cliConvertArgs(). No further
+         * error message is printed if the command fails and the caller of
+         * Cli::read(), Cli::loop() or Cli::execLine() gets INT8_MIN, same as
+         * for a parsing error.
+         */
+        static void reject(void);
+
+        /**
+         * @brief Used to check if the command called last by invoke() or
+         * resume() has rejected its input, see reject(). The state is
+         * cleared, so a command executed from within another one does not
+         * leave it set for the outer one.
+         *
+         * @return true if the input has been rejected.
+         */
+        static bool takeRejected(void);
+
+        /**
+         * @brief Used to call the function of the given command table entry.
+         * Records the statistics of the command if CLI_CMD_STATS is enabled.
+         * A task command is called until it has finished.
+         *
+         * @param pCmd The command table entry, see find().
+         * @param ioStream The stream to use for io operations.
+         * @param argv The arguments of the command.
+         * @param argc The number of arguments.
+         *
+         * @return The return value of the command.
+         */
+        static int8_t invoke(const cliCmd_t* pCmd, Stream& ioStream,
+            const char* argv[], uint8_t argc);
+
+#if CLI_CMD_TASKS != 0
+        /**
+         * @brief Used to call the task function of the given command table
+         * entry once. Records the statistics of the command if CLI_CMD_STATS
+         * is enabled, a call is counted once the task has finished.
+         *
+         * @param pCmd The command table entry of a task command.
+         * @param ioStream The stream to use for io operations.
+         * @param argv The arguments of the command.
+         * @param argc The number of arguments.
+         * @param ctx The state of the task, to be zeroed before the first
+         * call.
+         *
+         * @return The return value of the task, CLI_CMD_BUSY if it has not
+         * finished yet.
+         */
+        static int8_t resume(const cliCmd_t* pCmd, Stream& ioStream,
+            const char* argv[], uint8_t argc, cliTaskCtx_t& ctx);
+#endif
+
+#if CLI_CMD_STATS != 0
+        /**
+         * @brief Used to get the execution statistics of a command.
+         *
+         * @param idx The index of the command in the table, see getTable().
+         *
+         * @return Pointer to the statistics or nullptr if idx is invalid.
+         */
+        static const cliCmdStats_t* getStats(size_t idx);
+
+        /**
+         * @brief Used to reset the execution statistics of all commands.
+         */
+        static void resetStats(void);
+#endif
+
         /**
          * @brief Used to execute a command by its name.
          *
@@ -126,6 +724,26 @@ class CliCommand {
         static int8_t exec(Stream& ioStream, const char* name,
             const char* argv[], uint8_t argc);
 
+#if CLI_SUBCOMMANDS != 0
+        /**
+         * @brief Used by the command function of a group to execute the
+         * subcommand given by the first argument. Prints an error message and
+         * the available subcommands if there is no such subcommand.
+         *
+         * @param group The group, see CLI_SUBGROUP().
+         * @param ioStream The stream to use for io operations.
+         * @param argv The arguments of the group, starting with the name of
+         * the subcommand.
+         * @param argc The number of arguments.
+         *
+         * @return The return value of the subcommand, INT8_MIN if not found,
+         * which is rejected by reject().
+         */
+        static int8_t dispatchSub(const cliCmdGroup_t& group,
+            Stream& ioStream, const char* argv[], uint8_t argc);
+#endif
+
+#if CLI_CMDTAB_STATIC == 0
     private:
 
         /**
@@ -142,4 +760,10 @@ class CliCommand {
          * @brief The number of commands which could not be registered.
          */
         static size_t DropCnt;
+
+        /**
+         * @brief States if the command table is sorted, see isSorted().
+         */
+        static bool Sorted;
+#endif
 };
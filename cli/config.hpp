@@ -39,6 +39,84 @@
 #define CLI_COMMANDS_MAX            10
 #endif
 
+#ifndef CLI_CMDTAB_STATIC
+/**
+ * @brief Enable to define the command table at compile time instead of
+ * registering commands at startup.
+ *
+ * If enabled, CLI_COMMAND(name) only defines the command function and the
+ * command table has to be defined once by CLI_COMMAND_TABLE(), see
+ * cli/command.hpp. The table is then a constant, alphabetically sorted array
+ * which is verified at compile time. No static registrar objects, no
+ * constructors before main(), no sorting at runtime and no RAM for the table.
+ * CLI_COMMANDS_MAX is not used in this mode.
+ */
+#define CLI_CMDTAB_STATIC           0
+#endif
+
+#ifndef CLI_CMD_STATS
+/**
+ * @brief Enable per command execution statistics.
+ *
+ * If enabled, the number of calls, the number of failed calls (non-zero
+ * return code) and the total, maximum and last execution time are recorded
+ * for every command, see CliCommand::getStats(). Costs 20 bytes RAM per
+ * command and two timer reads per command execution.
+ */
+#define CLI_CMD_STATS               0
+#endif
+
+#ifndef CLI_CMD_STATS_TIMER
+/**
+ * @brief The timer used to measure the command execution time, must return a
+ * uint32_t compatible free running counter. Could be replaced by a cycle
+ * counter for a higher resolution, e.g. DWT->CYCCNT on Cortex-M3 and above.
+ */
+#define CLI_CMD_STATS_TIMER()       micros()
+#endif
+
+#ifndef CLI_CMD_STATS_COMMAND
+/**
+ * @brief Enable the built-in "cmdstat" command to print the statistics, only
+ * used if CLI_CMD_STATS is enabled.
+ */
+#define CLI_CMD_STATS_COMMAND       1
+#endif
+
+#ifndef CLI_CMD_TASKS
+/**
+ * @brief Enable or disable task commands, see CLI_COMMAND_TASK().
+ *
+ * A task command may return CLI_CMD_BUSY to be called again by Cli::loop()
+ * until it finishes, instead of blocking the main loop while it runs. Adds a
+ * second function pointer to each entry of the command table.
+ */
+#define CLI_CMD_TASKS               0
+#endif
+
+#ifndef CLI_SUBCOMMANDS
+/**
+ * @brief Enable or disable subcommand groups, see CLI_COMMAND_GROUP().
+ *
+ * A group is a command whose first argument selects a subcommand from its
+ * own table, e.g. "net ip set 10.0.0.1". Tab completion works on each level.
+ * Adds a pointer to each entry of the command table.
+ */
+#define CLI_SUBCOMMANDS             0
+#endif
+
+#ifndef CLI_PREFIX_MATCH
+/**
+ * @brief Enable or disable abbreviated commands.
+ *
+ * If enabled, a command may be given by any prefix of its name which matches
+ * no other command, e.g. "sta" for "status". A name typed in full is always
+ * executed, even if it is the prefix of other names. This applies to the
+ * subcommands of groups as well.
+ */
+#define CLI_PREFIX_MATCH            0
+#endif
+
 #ifndef CLI_COMMANDSIZ
 /**
  * @brief Defines the maximum length of a command including all arguments in
@@ -55,6 +133,54 @@
 static_assert(CLI_COMMANDSIZ <= 256,
     "CLI_COMMANDSIZ must be <= 256, the internal buffer index is a uint8_t");
 
+#ifndef CLI_RXCHUNKSIZ
+/**
+ * @brief Defines the maximum number of bytes Cli::loop() fetches from the
+ * stream at once.
+ *
+ * All bytes available on the stream are drained in chunks of up to this size
+ * and processed in bulk, see Cli::read(const char*, size_t, int8_t*). Set to
+ * 0 to fall back to reading a single byte per call of Cli::loop().
+ */
+#define CLI_RXCHUNKSIZ              16
+#endif
+
+/**
+ * @brief The receive chunk indices are uint8_t's.
+ */
+static_assert(CLI_RXCHUNKSIZ <= 255,
+    "CLI_RXCHUNKSIZ must be <= 255, the internal chunk index is a uint8_t");
+
+#ifndef CLI_RXRINGSIZ
+/**
+ * @brief Defines the size of the receive ring of each session in bytes, see
+ * Cli::pushFromIsr().
+ *
+ * The ring is filled by another context, e.g. a UART interrupt or the second
+ * core, and drained by Cli::loop() before the stream is polled. Set to 0 to
+ * disable the ring.
+ */
+#define CLI_RXRINGSIZ               0
+#endif
+
+/**
+ * @brief The ring indices are free running uint16_t's wrapped by a mask.
+ */
+static_assert((CLI_RXRINGSIZ & (CLI_RXRINGSIZ - 1)) == 0 &&
+    CLI_RXRINGSIZ <= 32768,
+    "CLI_RXRINGSIZ must be 0 or a power of two <= 32768");
+
+#ifndef CLI_WAKEUP
+/**
+ * @brief Enable or disable the wakeup callback, see Cli::setWakeup().
+ *
+ * Allows the application to sleep while Cli::hasPendingWork() is false and
+ * to be woken up by Cli::notify(), which is called by Cli::pushFromIsr() as
+ * well.
+ */
+#define CLI_WAKEUP                  0
+#endif
+
 #ifndef CLI_HISTORYSIZ
 /**
  * @brief Defines the size of the command history ringbuffer in bytes.
@@ -82,6 +208,79 @@ static_assert(CLI_COMMANDSIZ <= 256,
     #define CLI_HISTORYSIZ 0
 #endif
 
+#ifndef CLI_HISTORY_POW2
+/**
+ * @brief Enable to round the size of the history buffer up to the next power
+ * of two.
+ *
+ * This way the wrap around of positions in the buffer is a simple bit mask.
+ * Otherwise a compare and subtract is used, both avoid a division which is a
+ * library call on cores without hardware divide like the Cortex-M0. Costs up
+ * to CLI_HISTORYSIZ - 1 additional bytes RAM.
+ */
+#define CLI_HISTORY_POW2            0
+#endif
+
+#ifndef CLI_HISTORY_ENTRIES
+/**
+ * @brief Defines the maximum number of lines stored in the command history.
+ *
+ * The start of every line is kept in a small index next to the history
+ * buffer, so navigating and evicting lines is O(1) regardless of the buffer
+ * size. The index costs one byte per entry if CLI_HISTORYSIZ <= 256, two bytes
+ * otherwise, see CliHistory::get_index_size(). If the index is full, the oldest
+ * line is removed even if there would be space left in the buffer.
+ */
+#define CLI_HISTORY_ENTRIES         16
+#endif
+
+/**
+ * @brief The number of stored history lines is a uint8_t and the line offsets
+ * are at most 16 bit.
+ */
+static_assert(CLI_HISTORY_ENTRIES >= 1 && CLI_HISTORY_ENTRIES <= 255,
+    "CLI_HISTORY_ENTRIES must be between 1 and 255");
+static_assert(CLI_HISTORYSIZ <= 65536,
+    "CLI_HISTORYSIZ must be <= 65536, the history index uses 16 bit offsets");
+
+#ifndef CLI_HISTORY_JOURNAL
+/**
+ * @brief Enable support for a persistent command history, see CliJournal.
+ *
+ * Every command added to the history is appended as small record to a
+ * journal on a user provided storage, e.g. EEPROM or flash. The history is
+ * restored from the journal after a reset.
+ */
+#define CLI_HISTORY_JOURNAL         0
+#endif
+
+#ifndef CLI_HISTORY_SEARCH
+/**
+ * @brief Defines the maximum length of the search pattern of the reverse
+ * incremental history search, started by ctrl-R.
+ *
+ * Set to 0 to disable the history search.
+ */
+#define CLI_HISTORY_SEARCH          16
+#endif
+
+/**
+ * @brief The search pattern length is a uint8_t.
+ */
+static_assert(CLI_HISTORY_SEARCH <= 255,
+    "CLI_HISTORY_SEARCH must be <= 255, the pattern length is a uint8_t");
+
+#ifndef CLI_HISTORY_SHARED
+/**
+ * @brief Enable to share a single command history between all Cli instances
+ * (sessions) instead of one history per instance.
+ *
+ * Saves CLI_HISTORYSIZ bytes per additional session. Each session still
+ * navigates through the shared history independently.
+ */
+#define CLI_HISTORY_SHARED          0
+#endif
+
 #ifndef CLI_ARGVSIZ
 /**
  * @brief Defines the maximum number of arguments.
@@ -115,6 +314,79 @@ static_assert(CLI_COMMANDSIZ <= 256,
 #define cli_fflush()
 #endif
 
+#ifndef CLI_TXBUFSIZ
+/**
+ * @brief Defines the size of the output staging buffer in bytes.
+ *
+ * If not zero, all output generated by the library while processing input
+ * (echo, prompt, VT100 sequences, completion listings, error messages) is
+ * collected and written by a single Stream::write() call per input event.
+ * This is recommended for packet based streams like TCP or USB, where each
+ * write may end up in a packet of its own. Set to 0 to write all output
+ * directly.
+ */
+#define CLI_TXBUFSIZ                0
+#endif
+
+static_assert(CLI_TXBUFSIZ <= 65535,
+    "CLI_TXBUFSIZ must be <= 65535, the internal buffer index is a uint16_t");
+
+#ifndef CLI_TX_NONBLOCK
+/**
+ * @brief Enable or disable non-blocking output.
+ *
+ * If set to 1 the output staging buffer becomes a queue. Only as many bytes as
+ * Stream::availableForWrite() reports are written, the rest is kept and
+ * written later on by Cli::loop(). Output which does not fit into the queue is
+ * dropped. So a slow or stalled stream never blocks the processing of input.
+ * Pending output is written blocking before a command is executed, as the
+ * command writes to the stream directly. Response frames of CLI_FRAMED are
+ * written blocking as well, a frame cut short would desync the host.
+ *
+ * Requires CLI_TXBUFSIZ > 0 and a stream which implements availableForWrite(),
+ * the default of the Arduino Print class always returns 0.
+ */
+#define CLI_TX_NONBLOCK             0
+#endif
+
+static_assert(CLI_TX_NONBLOCK == 0 || CLI_TXBUFSIZ > 0,
+    "CLI_TX_NONBLOCK requires the output staging buffer, CLI_TXBUFSIZ > 0");
+
+#ifndef CLI_FRAMED
+/**
+ * @brief Enable or disable the framed request/response protocol.
+ *
+ * If set to 1, a request frame starting with DLE STX (0x10 0x02) can be sent
+ * at any time on the same stream as the interactive input. It carries a
+ * command line, which is executed like by Cli::execLine(), and is answered
+ * by a response frame carrying the return code and the captured output of
+ * the command. See doc/API.md for the frame format.
+ */
+#define CLI_FRAMED                  0
+#endif
+
+#ifndef CLI_FRAME_OUTSIZ
+/**
+ * @brief Defines the maximum command output in bytes which is captured for a
+ * response frame, see CLI_FRAMED. Further output is dropped. The buffer is
+ * shared by all sessions.
+ */
+#define CLI_FRAME_OUTSIZ            256
+#endif
+
+static_assert(CLI_FRAME_OUTSIZ > 0 && CLI_FRAME_OUTSIZ <= 65535,
+    "CLI_FRAME_OUTSIZ must be 1..65535, the response length is a uint16_t");
+
+#ifndef CLI_FRAME_TIMEOUT
+/**
+ * @brief Defines the maximum time in milliseconds between two bytes of a
+ * request frame, see CLI_FRAMED. A partial frame is dropped once the next
+ * byte arrives later, so a host which has been restarted in the middle of a
+ * frame can't desync the session. Set to 0 to disable the timeout.
+ */
+#define CLI_FRAME_TIMEOUT           500
+#endif
+
 #ifndef CLI_TAB_COMPLETION
 /**
  * @brief Enable or disable tab completion feature.
@@ -137,6 +409,18 @@ static_assert(CLI_COMMANDSIZ <= 256,
 #define CLI_CMDTAB_SORTING_DEFAULT              false
 #endif
 
+#ifndef CLI_TAB_CYCLE
+/**
+ * @brief Enable to cycle through the matching commands by pressing tab
+ * repeatedly (menu-complete), only used if CLI_TAB_COMPLETION is enabled.
+ *
+ * The first tab completes the common prefix and lists the matches like
+ * without this option. Each further tab replaces the input by the next match,
+ * after the last match the common prefix is restored.
+ */
+#define CLI_TAB_CYCLE               0
+#endif
+
 #ifndef CLI_TERMINAL_WIDTH
 /**
  * @brief Defines the assumed terminal width in characters.
@@ -0,0 +1,138 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+#pragma once
+
+#include <Arduino.h>
+#if __has_include ("cli_config.hpp")
+#include "cli_config.hpp"
+#endif
+#include "cli/config.hpp"
+
+#if CLI_FRAMED != 0
+
+/**
+ * @brief Response frame flag, the output of the command has been truncated to
+ * CLI_FRAME_OUTSIZ bytes.
+ */
+#define CLI_FRAME_TRUNCATED         0x01
+
+/**
+ * @brief Response frame flag, the CRC of the request frame was wrong. The
+ * command has not been executed.
+ */
+#define CLI_FRAME_CRC_ERROR         0x02
+
+/**
+ * @brief Response frame flag, the command line of the request frame was
+ * longer than CLI_COMMANDSIZ - 1. The command has not been executed.
+ */
+#define CLI_FRAME_TOO_LONG          0x04
+
+/**
+ * @brief A stream which captures everything written to it in a fixed size
+ * buffer. Used to collect the output of a command for a response frame,
+ * output which does not fit is dropped.
+ */
+class CliCapture : public Stream {
+
+    public:
+
+        /**
+         * @brief Construct a new capture stream.
+         *
+         * @param pBuf The buffer to capture the output in.
+         * @param size The size of the buffer.
+         */
+        CliCapture(char *pBuf, size_t size) :
+            pBuf(pBuf), Size(size), Len(0), Truncated(false) {
+        }
+
+        size_t write(uint8_t byte);
+
+        size_t write(const uint8_t *buf, size_t len);
+
+        using Stream::write;
+
+        int availableForWrite(void) {
+            return (int) (Size - Len);
+        }
+
+        int available(void) {
+            return 0;
+        }
+
+        int read(void) {
+            return -1;
+        }
+
+        int peek(void) {
+            return -1;
+        }
+
+        /**
+         * @brief Used to get the captured output.
+         */
+        const char* data(void) const {
+            return pBuf;
+        }
+
+        /**
+         * @brief Used to get the number of captured bytes.
+         */
+        size_t length(void) const {
+            return Len;
+        }
+
+        /**
+         * @brief Used to check if output has been dropped.
+         */
+        bool isTruncated(void) const {
+            return Truncated;
+        }
+
+    private:
+
+        /**
+         * @brief The buffer to capture the output in.
+         */
+        char *pBuf;
+
+        /**
+         * @brief The size of the buffer.
+         */
+        size_t Size;
+
+        /**
+         * @brief The number of captured bytes.
+         */
+        size_t Len;
+
+        /**
+         * @brief States if output has been dropped.
+         */
+        bool Truncated;
+};
+
+#endif
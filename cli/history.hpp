@@ -26,6 +26,7 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <string.h>
 
 #if __has_include ("cli_config.hpp")
 #include "cli_config.hpp"
@@ -34,35 +35,93 @@
 
 #if CLI_HISTORYSIZ > 0
 
+#if CLI_HISTORY_JOURNAL != 0
+class CliJournal;
+#endif
+
+/**
+ * @brief Used to get the smallest power of two which is >= n.
+ */
+constexpr size_t cliHistoryPow2(size_t n, size_t pow2 = 1) {
+    return pow2 >= n ? pow2 : cliHistoryPow2(n, pow2 * 2);
+}
+
+/**
+ * @brief The actual size of the history buffer, see CLI_HISTORY_POW2.
+ */
+#if CLI_HISTORY_POW2 != 0
+#define CLI_HISTORY_BUFSIZ          cliHistoryPow2(CLI_HISTORYSIZ)
+#else
+#define CLI_HISTORY_BUFSIZ          CLI_HISTORYSIZ
+#endif
+
 /**
  * @brief A class to store lines of text in a fixed-size circular buffer.
  *
  * This calls is designed to act as a shell history for libcli and is not
  * intended for general use. It provides the following functionality:
  * - Store lines of text in a fixed-size circular buffer.
- * - Maximum memory efficiency
- *   - only storing the lines and a null terminator, no additional metadata.
+ * - Memory efficiency
+ *   - only storing the lines and a null terminator in the buffer.
  *   - Stored lines may warp around the end of the buffer.
+ *   - The start offset of every line is kept in a small index ring of
+ *     CLI_HISTORY_ENTRIES entries, see get_index_size().
  * - Every write operation will ...
- *   - Set the read pointer to the new line.
  *   - Automatically free space as needed by removing the old lines.
- * - Seek forward and backward through the stored lines.
- * - Read the line at the current read pointer position into a provided buffer.
+ * - Seek forward and backward through the stored lines, or directly to the
+ *   n-th most recent line. All of them are O(1) thanks to the index.
+ * - Read the line at the current read position into a provided buffer.
+ *
+ * The read position is not part of this class but of a cursor owned by the
+ * user of the history. This way several sessions can navigate through a
+ * shared history independently.
  */
 class CliHistory {
 
     public:
+
+#if CLI_HISTORYSIZ <= 256
+        /**
+         * @brief The type of a line offset in the buffer. Rounding up to a
+         * power of two never exceeds 256 or 65536 if CLI_HISTORYSIZ doesn't.
+         */
+        typedef uint8_t offset_t;
+#else
+        typedef uint16_t offset_t;
+#endif
+
+        /**
+         * @brief The navigation state of a user of the history.
+         */
+        typedef struct {
+
+            /**
+             * @brief The sequence number of the line to read. Every appended
+             * line gets the next number, so the cursor stays on its line when
+             * more lines are added. If the line has been removed meanwhile,
+             * the cursor is outdated and starts over at the most recent line.
+             */
+            uint16_t seq;
+
+            /**
+             * @brief Used to indicate if the history is currently used for
+             * restoring commands. It is provided by this class as it belongs
+             * to it's context but has to be used and managed outisde of this
+             * class.
+             */
+            bool is_used;
+
+        } cursor_t;
+
         CliHistory(void);
         ~CliHistory(void);
 
         /**
          * @brief Store the given string in the internal buffer.
          *
-         * This function will ...
-         *   - automatically free space as needed by removing the oldest line in
-         *     the buffer until the new data can be stored.
-         *   - set the the read pointer to the new line which is then the newest
-         *     line in the buffer.
+         * This function will automatically free space as needed by removing
+         * the oldest line in the buffer until the new data can be stored and
+         * there is a free index entry.
          *
          * @param str   Pointer to the string to store, must be null-terminated.
          * @param len   The length of the string to store excluding the null
@@ -75,33 +134,61 @@ class CliHistory {
         bool append(const char *str, size_t len);
 
         /**
-         * @brief Move the read pointer to the previous (older) line.
+         * @brief Set the given cursor to the most recent line and clear its
+         * is_used flag.
+         *
+         * @param cur   The cursor to set.
+         */
+        void rewind(cursor_t &cur);
+
+        /**
+         * @brief Set the given cursor to the n-th most recent line.
+         *
+         * @param cur   The cursor to set.
+         * @param n     The number of the line, 0 is the most recent line.
+         *
+         * @return  true if the cursor has been set
+         *          false if there is no such line, the cursor is unchanged
+         */
+        bool seek(cursor_t &cur, size_t n);
+
+        /**
+         * @brief Move the read position of the given cursor to the previous
+         * (older) line. An outdated cursor is set to the most recent line
+         * instead.
          *
-         * @return  true if the read pointer was successfully moved
+         * @param cur   The cursor to move.
+         *
+         * @return  true if the read position was successfully moved
          *          false if there is no previous line
          */
-        bool seek_backward(void);
+        bool seek_backward(cursor_t &cur);
 
         /**
-         * @brief Move the read pointer to the next (more recent) line.
+         * @brief Move the read position of the given cursor to the next (more
+         * recent) line.
+         *
+         * @param cur   The cursor to move.
          *
-         * @return  true if the read pointer was successfully moved
-         *          false if there is no next line
+         * @return  true if the read position was successfully moved
+         *          false if there is no next line or the cursor is outdated
          */
-        bool seek_forward(void);
+        bool seek_forward(cursor_t &cur);
 
         /**
-         * @brief Read the line at the current read pointer position into the
-         * provided buffer.
+         * @brief Read the line at the read position of the given cursor into
+         * the provided buffer. An outdated cursor is set to the most recent
+         * line before.
          *
-         * This function will copy the line at the current read pointer
-         * position into the provided buffer while taking care of the potential
-         * wrap-around of the internal buffer. The line is copied including the
-         * null terminator, so the provided buffer must be large enough to hold
-         * the line including the null terminator. If the provided buffer is
-         * too small, the function will return 0, but the given buffer will be
+         * This function will copy the line at the current read position into
+         * the provided buffer while taking care of the potential wrap-around
+         * of the internal buffer. The line is copied including the null
+         * terminator, so the provided buffer must be large enough to hold the
+         * line including the null terminator. If the provided buffer is too
+         * small, the function will return 0 and the given buffer is not
          * modified.
          *
+         * @param cur   The cursor to read from.
          * @param line  Pointer to the buffer where the line should be copied,
          *              must be large enough to hold the line including the null
          *              terminator.
@@ -111,7 +198,44 @@ class CliHistory {
          *          Returns 0 if there is no line to read or if the provided
          *          buffer is too small.
          */
-        size_t read(char *line, size_t max_len);
+        size_t read(cursor_t &cur, char *line, size_t max_len);
+
+        /**
+         * @brief Search for a line containing the given pattern, starting at
+         * the line of the given cursor towards older lines. The lines are
+         * compared in place, taking care of the wrap-around.
+         *
+         * @param cur   The cursor to start at, set to the matching line. An
+         *              outdated cursor is set to the most recent line before.
+         * @param str   The pattern to search for, not null terminated.
+         * @param len   The length of the pattern.
+         * @param skip  Start at the line before the one of the cursor.
+         *
+         * @return  true if a matching line has been found
+         *          false otherwise, the cursor is unchanged
+         */
+        bool search(cursor_t &cur, const char *str, size_t len, bool skip);
+
+        /**
+         * @brief Get the line at the read position of the given cursor in
+         * place. Due to the wrap-around, the line may be split into two
+         * segments. An outdated cursor is set to the most recent line before.
+         *
+         * @param cur       The cursor to read from.
+         * @param seg       Set to the start of the two segments.
+         * @param seglen    Set to the length of the two segments, the second
+         *                  one is zero if the line does not wrap around.
+         *
+         * @return  The length of the line, 0 if there is no line.
+         */
+        size_t peek(cursor_t &cur, const char *seg[2], size_t seglen[2]);
+
+        /**
+         * @brief Get the number of stored lines.
+         *
+         * @return The number of lines, at most CLI_HISTORY_ENTRIES.
+         */
+        size_t get_count(void);
 
         /**
          * @brief Get the amount of free space available in the buffer.
@@ -120,87 +244,148 @@ class CliHistory {
          */
         size_t get_free_space(void);
 
+        /**
+         * @brief Get the memory used by the line index in addition to the
+         * buffer of CLI_HISTORYSIZ bytes.
+         *
+         * @return The size of the index in bytes.
+         */
+        static constexpr size_t get_index_size(void) {
+            return sizeof(offset_t) * CLI_HISTORY_ENTRIES;
+        }
+
         /**
          * @brief Clear the internal buffer, all data will be lost.
          */
         void clear(void);
 
+#if CLI_HISTORY_JOURNAL != 0
         /**
-         * @brief Used to indicate if the history is currently used for
-         * restoring commands. It is provided by this class as it belongs to
-         * it's context but has to be used and managed outisde of this class.
+         * @brief Set the journal every appended line is written to, see
+         * CliJournal.
+         *
+         * @param pJrnl The journal to use, nullptr to disable.
          */
-        bool is_used;
+        void set_journal(CliJournal *pJrnl);
+#endif
 
     private:
 
         /**
-         * @brief Increment the given pointer while respecting the wrap around.
+         * @brief Add the given increment to the given offset while respecting
+         * the wrap around. Avoids a division, see CLI_HISTORY_POW2.
          *
-         * @param ptr           The pointer to increment
-         * @param increment     The number of bytes to increment, default is 1
+         * @param off           The offset to increment
+         * @param increment     The number of bytes to increment, default is 1,
+         *                      must not be larger than the buffer.
+         */
+        inline size_t increment_position(size_t off, size_t increment = 1) {
+            off += increment;
+#if CLI_HISTORY_POW2 != 0
+            return off & (sizeof(Buffer) - 1);
+#else
+            return off < sizeof(Buffer) ? off : off - sizeof(Buffer);
+#endif
+        }
+
+        /**
+         * @brief Get the number of bytes from the given offset up to the end
+         * of the buffer, at most len. This is the first of the at most two
+         * segments a range of len bytes is split into by the wrap around.
          */
-        inline void increment_position(char *&ptr, size_t increment = 1) {
-            const size_t size = sizeof(Buffer);
-            const size_t index = static_cast<size_t>(ptr - Buffer);
-            ptr = Buffer + ((index + increment) % size);
+        inline size_t segment(size_t off, size_t len) {
+            size_t space_to_end = sizeof(Buffer) - off;
+            return len < space_to_end ? len : space_to_end;
         }
 
         /**
-         * @brief Decrement the given pointer while respecting the wrap around.
+         * @brief Used to compare len bytes of the buffer at the given offset
+         * with the given string, taking care of the wrap-around.
          *
-         * @param ptr           The pointer to decrement
-         * @param decrement     The number of bytes to decrement, default is 1
+         * @return true if they are equal.
          */
-        inline void decrement_position(char *&ptr, size_t decrement = 1) {
-            const size_t size = sizeof(Buffer);
-            const size_t index = static_cast<size_t>(ptr - Buffer);
-            decrement %= size;
-            ptr = Buffer + ((index + size - decrement) % size);
+        inline bool equals(size_t off, const char *str, size_t len) {
+            size_t first = segment(off, len);
+
+            return memcmp(&Buffer[off], str, first) == 0 &&
+                memcmp(Buffer, str + first, len - first) == 0;
         }
 
         /**
-         * @brief Reset the navigation state to the most recent entry.
-         * 
-         * Sets pRead to pLast and clears the is_used flag.
+         * @brief Get the index slot of the line with the given age.
+         *
+         * @param age   The age of the line, 1 is the most recent line.
          */
-        inline void reset_navigation(void) {
-            pRead = pLast;
-            is_used = false;
+        inline size_t slot(size_t age) {
+            size_t idx = First + Count - age;
+            return idx < CLI_HISTORY_ENTRIES ? idx : idx - CLI_HISTORY_ENTRIES;
+        }
+
+        /**
+         * @brief Get the length of the line with the given age excluding the
+         * null terminator. The line ends where the next line or the head
+         * starts.
+         *
+         * @param age   The age of the line, 1 is the most recent line.
+         */
+        size_t line_len(size_t age);
+
+        /**
+         * @brief Get the age of the line the given cursor refers to, 1 is the
+         * most recent line. The cursor is valid if the result is between 1
+         * and Count.
+         */
+        inline size_t age(const cursor_t &cur) {
+            return static_cast<uint16_t>(Seq - cur.seq);
+        }
+
+        /**
+         * @brief Used to check if the given cursor refers to a stored line.
+         */
+        inline bool is_valid(const cursor_t &cur) {
+            return age(cur) >= 1 && age(cur) <= Count;
         }
 
         /**
          * @brief Internal buffer to store the lines.
          */
-        char Buffer [CLI_HISTORYSIZ];
+        char Buffer [CLI_HISTORY_BUFSIZ];
+
+        /**
+         * @brief The start offsets of the stored lines, a ring starting at the
+         * slot First with Count entries ordered from the oldest to the most
+         * recent line.
+         */
+        offset_t Index [CLI_HISTORY_ENTRIES];
 
         /**
-         * @brief Pointer to the position in the buffer where the next data will
-         * be written. Is always set to a valid position.
+         * @brief Offset in the buffer where the next data will be written.
          */
-        char *pHead;
+        offset_t Head;
 
         /**
-         * @brief Pointer to the position in the buffer where the last written
-         * line starts as this is first to read. Note that this is not the tail
-         * of the buffer. If it is zero, the buffer is considered empty.
+         * @brief The index slot of the oldest line, which is the tail of the
+         * buffer.
          */
-        char *pRead;
-        /* data */
+        uint8_t First;
 
         /**
-         * @brief Pointer to the position in the buffer where the oldest line
-         * starts. This is the tail of the buffer. If it is zero, the buffer is
-         * considered empty.
+         * @brief The number of stored lines, zero if the buffer is empty.
          */
-        char *pTail;
+        uint8_t Count;
 
         /**
-         * @brief Pointer to the start of the most recently added line in the
-         * buffer. Used to detect and prevent duplicate consecutive entries.
-         * If it is zero, the buffer is considered empty.
+         * @brief The sequence number the next appended line will get, see
+         * cursor_t::seq.
          */
-        char *pLast;
+        uint16_t Seq;
+
+#if CLI_HISTORY_JOURNAL != 0
+        /**
+         * @brief The journal to write appended lines to, may be nullptr.
+         */
+        CliJournal *pJournal;
+#endif
 };
 
 #endif // CLI_HISTORYSIZ > 0
\ No newline at end of file
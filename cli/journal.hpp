@@ -0,0 +1,227 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#if __has_include ("cli_config.hpp")
+#include "cli_config.hpp"
+#endif
+#include "cli/config.hpp"
+#include "cli/history.hpp"
+
+#if CLI_HISTORYSIZ > 0 && CLI_HISTORY_JOURNAL != 0
+
+/**
+ * @brief The interface to a persistent storage used by CliJournal.
+ *
+ * The storage is a linear range of bytes, e.g. a part of a EEPROM, some flash
+ * pages or a file. Implementations have to take care of the page and write
+ * granularity of the underlying memory.
+ */
+class CliJournalStorage {
+
+    public:
+
+        virtual ~CliJournalStorage() {}
+
+        /**
+         * @brief Get the size of the storage in bytes.
+         */
+        virtual size_t size(void) = 0;
+
+        /**
+         * @brief Read data from the storage.
+         *
+         * @param addr  The address within the storage to read from.
+         * @param data  The buffer to read into.
+         * @param len   The number of bytes to read.
+         *
+         * @return true in case of success.
+         */
+        virtual bool read(size_t addr, void *data, size_t len) = 0;
+
+        /**
+         * @brief Write data to the storage. Every address is written at most
+         * once between two calls of erase(), so flash can be written
+         * directly.
+         *
+         * @param addr  The address within the storage to write to.
+         * @param data  The data to write.
+         * @param len   The number of bytes to write.
+         *
+         * @return true in case of success.
+         */
+        virtual bool write(size_t addr, const void *data, size_t len) = 0;
+
+        /**
+         * @brief Erase the whole storage, all bytes must read as 0xFF
+         * afterwards.
+         *
+         * @return true in case of success.
+         */
+        virtual bool erase(void) = 0;
+};
+
+/**
+ * @brief Counters of a journal, see CliJournal::getStats().
+ */
+typedef struct {
+
+    /**
+     * @brief Number of history lines written to the journal since boot.
+     */
+    uint32_t appends;
+
+    /**
+     * @brief Number of bytes of the history lines appended since boot.
+     */
+    uint32_t requested;
+
+    /**
+     * @brief Number of bytes written to the storage since boot, including
+     * record headers and compaction. The write amplification is written
+     * divided by requested.
+     */
+    uint32_t written;
+
+    /**
+     * @brief Number of compactions since boot.
+     */
+    uint32_t compactions;
+
+    /**
+     * @brief Number of erase cycles of the storage over its lifetime, this
+     * counter is stored in the journal itself.
+     */
+    uint32_t erases;
+
+} cliJournalStats_t;
+
+/**
+ * @brief A append-only journal used to make the command history persistent.
+ *
+ * The journal starts with a small header followed by one record per history
+ * line, each consisting of the length, a CRC-8 and the line itself. Adding a
+ * line to the history appends a single record. If the storage is full, it is
+ * erased and the current content of the history is written as new journal,
+ * this is called compaction. At boot, the records are replayed into the
+ * history, a torn record at the end is detected by its CRC and ignored.
+ *
+ * The storage can only be erased as a whole, so a compaction can't keep the
+ * old journal until the new one is complete. A reset during a compaction
+ * loses the lines which have not been rewritten yet.
+ */
+class CliJournal {
+
+    public:
+
+        /**
+         * @brief Construct a new journal on the given storage.
+         *
+         * @param storage   The storage to use, see CliJournalStorage.
+         */
+        CliJournal(CliJournalStorage &storage);
+
+        /**
+         * @brief Used to restore the given history from the journal. A
+         * storage without valid journal is erased and initialized.
+         *
+         * @param history   The history to restore.
+         *
+         * @return The number of restored lines.
+         */
+        size_t restore(CliHistory &history);
+
+        /**
+         * @brief Used to append a line which has just been added to the given
+         * history, called by CliHistory::append().
+         *
+         * @param history   The history, used for compaction if needed.
+         * @param str       The line, not null terminated.
+         * @param len       The length of the line.
+         *
+         * @return true in case of success.
+         */
+        bool append(CliHistory &history, const char *str, size_t len);
+
+        /**
+         * @brief Used to get the journal counters.
+         *
+         * @return A copy of the current counters.
+         */
+        cliJournalStats_t getStats(void);
+
+    private:
+
+        /**
+         * @brief Used to erase the storage and write a new journal header.
+         *
+         * @return true in case of success.
+         */
+        bool format(void);
+
+        /**
+         * @brief Used to write the current content of the given history as new
+         * journal. The oldest lines are skipped if they don't fit. The storage
+         * is erased first, a reset meanwhile keeps only the lines written so
+         * far, oldest first. A reset before the journal header is written
+         * loses the erase counter as well.
+         *
+         * @return true in case of success.
+         */
+        bool compact(CliHistory &history);
+
+        /**
+         * @brief Used to write a single record at the end of the journal.
+         *
+         * @return true in case of success, false if it does not fit.
+         */
+        bool writeRecord(const char *str, size_t len);
+
+        /**
+         * @brief The storage to use.
+         */
+        CliJournalStorage &Storage;
+
+        /**
+         * @brief The address of the next record to write.
+         */
+        size_t End;
+
+        /**
+         * @brief Used to indicate that the storage after End can't be written
+         * directly, e.g. after a torn record, so the next append compacts.
+         */
+        bool Dirty;
+
+        /**
+         * @brief The journal counters, see getStats().
+         */
+        cliJournalStats_t Stats;
+};
+
+#endif // CLI_HISTORYSIZ > 0 && CLI_HISTORY_JOURNAL != 0
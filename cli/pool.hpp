@@ -0,0 +1,119 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+#pragma once
+
+#include "cli/cli.hpp"
+
+/**
+ * @brief A statically allocated pool of Cli sessions.
+ *
+ * Intended for transports with a varying number of clients, e.g. a telnet
+ * server. A session is taken from the pool when a client connects and given
+ * back when it disconnects. All sessions share the command table, see Cli.
+ *
+ * @tparam N    The maximum number of concurrent sessions.
+ */
+template <size_t N>
+class CliPool {
+
+    public:
+
+        /**
+         * @brief Construct a new pool, all sessions are unused.
+         */
+        CliPool() : Used(), Begun(false) {
+        }
+
+        /**
+         * @brief Used to take a unused session from the pool and to start it
+         * on the given stream. The first session is started by Cli::begin(),
+         * all further ones by Cli::setStream(), so the output of begin() is
+         * not repeated for every client.
+         *
+         * @param pIoStr The stream to use for the session.
+         *
+         * @return Pointer to the session or nullptr if all are in use.
+         */
+        Cli* open(Stream *pIoStr) {
+            for (size_t i = 0; i < N; i++) {
+                if (Used[i] == false) {
+                    Used[i] = true;
+                    if (Begun) {
+                        Sessions[i].setStream(pIoStr);
+                    } else {
+                        Sessions[i].begin(pIoStr);
+                        Begun = true;
+                    }
+                    return &Sessions[i];
+                }
+            }
+
+            return nullptr;
+        }
+
+        /**
+         * @brief Used to give a session back to the pool. The session is
+         * ended, see Cli::end(), so the next client gets a clean one.
+         *
+         * @param pCli Pointer to the session as returned by open().
+         */
+        void close(Cli *pCli) {
+            for (size_t i = 0; i < N; i++) {
+                if (&Sessions[i] == pCli) {
+                    Sessions[i].end();
+                    Used[i] = false;
+                    return;
+                }
+            }
+        }
+
+        /**
+         * @brief Used to call Cli::loop() of all sessions in use.
+         */
+        void loop(void) {
+            for (size_t i = 0; i < N; i++) {
+                if (Used[i]) {
+                    Sessions[i].loop();
+                }
+            }
+        }
+
+    private:
+
+        /**
+         * @brief The sessions.
+         */
+        Cli Sessions[N];
+
+        /**
+         * @brief States which sessions are in use.
+         */
+        bool Used[N];
+
+        /**
+         * @brief Set once the first session has been started by Cli::begin().
+         */
+        bool Begun;
+};
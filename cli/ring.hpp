@@ -0,0 +1,207 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+
+#pragma once
+
+#include <Arduino.h>
+#if __has_include ("cli_config.hpp")
+#include "cli_config.hpp"
+#endif
+#include "cli/config.hpp"
+
+#if CLI_RXRINGSIZ > 0
+
+#include <string.h>
+
+/**
+ * @brief A lock-free single producer, single consumer byte ring of
+ * CLI_RXRINGSIZ bytes.
+ *
+ * The producer, e.g. a UART interrupt or the second core, calls push() and
+ * the consumer, Cli::loop(), calls peek() and consume(). Each index is only
+ * written by one side and published with release semantics, so no lock and
+ * no atomic read-modify-write instruction is needed, which some cores like
+ * the Cortex-M0+ don't have.
+ *
+ * The methods are defined here so they are inlined into the caller, e.g. an
+ * interrupt handler which has to be placed in RAM.
+ */
+class CliRxRing {
+
+    public:
+
+        /**
+         * @brief Construct a new empty ring.
+         */
+        CliRxRing() : Head(0), Tail(0), Overflows(0) {
+        }
+
+        /**
+         * @brief Used by the producer to add a byte.
+         *
+         * @param byte The byte to add.
+         *
+         * @return false if the ring is full and the byte has been dropped.
+         */
+        inline bool push(char byte) {
+            uint16_t head = __atomic_load_n(&Head, __ATOMIC_RELAXED);
+            uint16_t tail = __atomic_load_n(&Tail, __ATOMIC_ACQUIRE);
+
+            if ((uint16_t) (head - tail) >= CLI_RXRINGSIZ) {
+                drop(1);
+                return false;
+            }
+
+            Buf[head & Mask] = byte;
+            __atomic_store_n(&Head, (uint16_t) (head + 1), __ATOMIC_RELEASE);
+            return true;
+        }
+
+        /**
+         * @brief Used by the producer to add a block of bytes. What does not
+         * fit is dropped.
+         *
+         * @param data  Pointer to the bytes to add.
+         * @param len   The number of bytes.
+         *
+         * @return The number of bytes added.
+         */
+        inline size_t push(const char *data, size_t len) {
+            uint16_t head = __atomic_load_n(&Head, __ATOMIC_RELAXED);
+            uint16_t tail = __atomic_load_n(&Tail, __ATOMIC_ACQUIRE);
+            size_t space = CLI_RXRINGSIZ - (uint16_t) (head - tail);
+            size_t idx = head & Mask;
+            size_t cnt = len < space ? len : space;
+            size_t first = cnt < CLI_RXRINGSIZ - idx ? cnt : CLI_RXRINGSIZ - idx;
+
+            /* At most two copies, the second one if the block wraps around */
+            memcpy(&Buf[idx], data, first);
+            memcpy(&Buf[0], &data[first], cnt - first);
+            __atomic_store_n(&Head, (uint16_t) (head + cnt), __ATOMIC_RELEASE);
+
+            if (cnt < len) {
+                drop(len - cnt);
+            }
+
+            return cnt;
+        }
+
+        /**
+         * @brief Used by the consumer to get the received bytes without
+         * copying them. If the bytes wrap around the end of the ring, only the
+         * first part is returned, the rest by the next call after consume().
+         *
+         * @param pData Set to the first received byte.
+         *
+         * @return The number of bytes available at pData, 0 if none.
+         */
+        inline size_t peek(const char*& pData) {
+            uint16_t tail = __atomic_load_n(&Tail, __ATOMIC_RELAXED);
+            uint16_t head = __atomic_load_n(&Head, __ATOMIC_ACQUIRE);
+            size_t cnt = (uint16_t) (head - tail);
+            size_t idx = tail & Mask;
+
+            pData = &Buf[idx];
+            return cnt < CLI_RXRINGSIZ - idx ? cnt : CLI_RXRINGSIZ - idx;
+        }
+
+        /**
+         * @brief Used by the consumer to release bytes returned by peek(), so
+         * the producer can reuse their space.
+         *
+         * @param len The number of bytes to release.
+         */
+        inline void consume(size_t len) {
+            uint16_t tail = __atomic_load_n(&Tail, __ATOMIC_RELAXED);
+
+            __atomic_store_n(&Tail, (uint16_t) (tail + len), __ATOMIC_RELEASE);
+        }
+
+        /**
+         * @brief Used by the consumer to release all received bytes without
+         * processing them. The number of overflows is kept, as it is written
+         * by the producer only.
+         */
+        inline void discard(void) {
+            __atomic_store_n(&Tail, __atomic_load_n(&Head, __ATOMIC_ACQUIRE),
+                __ATOMIC_RELEASE);
+        }
+
+        /**
+         * @brief Used to check if there are received bytes.
+         */
+        inline bool isEmpty(void) {
+            return __atomic_load_n(&Head, __ATOMIC_ACQUIRE) ==
+                __atomic_load_n(&Tail, __ATOMIC_RELAXED);
+        }
+
+        /**
+         * @brief Used to get the number of bytes dropped as the ring was full.
+         */
+        inline uint32_t getOverflows(void) {
+            return __atomic_load_n(&Overflows, __ATOMIC_RELAXED);
+        }
+
+    private:
+
+        /**
+         * @brief Used by the producer to count dropped bytes. The producer is
+         * the only writer, so a plain load and store is sufficient.
+         */
+        inline void drop(size_t len) {
+            uint32_t cnt = __atomic_load_n(&Overflows, __ATOMIC_RELAXED);
+
+            __atomic_store_n(&Overflows, (uint32_t) (cnt + len),
+                __ATOMIC_RELAXED);
+        }
+
+        /**
+         * @brief The indices are free running and wrapped by this mask.
+         */
+        static constexpr uint16_t Mask = CLI_RXRINGSIZ - 1;
+
+        /**
+         * @brief The ring buffer.
+         */
+        char Buf[CLI_RXRINGSIZ];
+
+        /**
+         * @brief Number of bytes added so far, only written by the producer.
+         */
+        uint16_t Head;
+
+        /**
+         * @brief Number of bytes consumed so far, only written by the
+         * consumer.
+         */
+        uint16_t Tail;
+
+        /**
+         * @brief Number of dropped bytes, only written by the producer.
+         */
+        uint32_t Overflows;
+};
+
+#endif /* CLI_RXRINGSIZ > 0 */
@@ -35,6 +35,18 @@ const struct {
      */
     const char del[6] = "\b\033[0K";
 
+    /**
+     * @brief Used to erase from the cursor to the end of the line.
+     * CSI Ps K, PS = 0
+     */
+    const char clreol[5] = "\033[0K";
+
+    /**
+     * @brief Used to move the cursor back by up to 4 columns, which is
+     * shorter than a CUB sequence.
+     */
+    const char left[5] = "\b\b\b\b";
+
     /**
      * @brief Used for echo a delete line to the terminal.
      * Carriage Return + CSI Ps K, PS = 2
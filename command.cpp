@@ -24,20 +24,70 @@
 
 #include "cli/command.hpp"
 
+/**
+ * @brief States if the command called last has rejected its input, see
+ * CliCommand::reject().
+ */
+static bool Rejected = false;
+
+#if CLI_CMD_STATS != 0
+#if CLI_CMDTAB_STATIC == 0
+/**
+ * @brief The statistics of the commands, same index as in the command table.
+ */
+static cliCmdStats_t CmdStats[CLI_COMMANDS_MAX];
+#else
+/**
+ * @brief The statistics defined by CLI_COMMAND_TABLE().
+ */
+static cliCmdStats_t* const CmdStats = cliCmdStats;
+#endif
+#endif
+
+#if CLI_CMDTAB_STATIC == 0
+
 cliCmd_t CliCommand::CmdTab[CLI_COMMANDS_MAX];
 
 size_t CliCommand::CmdCnt = 0;
 
 size_t CliCommand::DropCnt = 0;
 
+bool CliCommand::Sorted = false;
+
 CliCommand::CliCommand(const char* name, CmdFuncPtr function) {
     if (CmdCnt < CLI_COMMANDS_MAX) {
-        CmdTab[CmdCnt++] = {name, function};
+        CmdTab[CmdCnt++] = {name, function CLI_ENTRY_TASK(nullptr)
+            CLI_ENTRY_SUB(nullptr)};
+        Sorted = false;
     } else {
         DropCnt++;
     }
 }
 
+#if CLI_CMD_TASKS != 0
+CliCommand::CliCommand(const char* name, CmdTaskPtr task) {
+    if (CmdCnt < CLI_COMMANDS_MAX) {
+        CmdTab[CmdCnt++] = {name, nullptr, task CLI_ENTRY_SUB(nullptr)};
+        Sorted = false;
+    } else {
+        DropCnt++;
+    }
+}
+#endif
+
+#if CLI_SUBCOMMANDS != 0
+CliCommand::CliCommand(const char* name, CmdFuncPtr function,
+                       const cliCmdGroup_t* pSub) {
+    if (CmdCnt < CLI_COMMANDS_MAX) {
+        CmdTab[CmdCnt++] = {name, function CLI_ENTRY_TASK(nullptr)
+            CLI_ENTRY_SUB(pSub)};
+        Sorted = false;
+    } else {
+        DropCnt++;
+    }
+}
+#endif
+
 /**
  * @brief Used to compare two commands for sorting the command table.
  * 
@@ -60,6 +110,17 @@ void CliCommand::sortTable(void) {
      * one-time init.
      */
     qsort(CmdTab, CmdCnt, sizeof(cliCmd_t), cmdCompare);  
+    Sorted = true;
+
+#if CLI_CMD_STATS != 0
+    /* The statistics don't move with their commands, usually there are none
+     * as sorting is done once before any command is executed. */
+    resetStats();
+#endif
+}
+
+bool CliCommand::isSorted(void) {
+    return Sorted;
 }
 
 cliCmd_t* CliCommand::getTable(void) {
@@ -74,23 +135,380 @@ size_t CliCommand::getDropCnt(void) {
     return DropCnt;
 }
 
-CmdFuncPtr CliCommand::getCmd(const char* name) {
-    for (size_t i = 0; i < CmdCnt; i++) {
-        if (strcmp(name, CmdTab[i].name) == 0) {
-            return CmdTab[i].pfunc;
+#else /* CLI_CMDTAB_STATIC == 0 */
+
+/**
+ * The command table is defined by CLI_COMMAND_TABLE() and has been verified
+ * to be sorted at compile time, so there is nothing to do at runtime.
+ */
+
+void CliCommand::sortTable(void) {
+}
+
+bool CliCommand::isSorted(void) {
+    return true;
+}
+
+const cliCmd_t* CliCommand::getTable(void) {
+    return cliCmdTab;
+}
+
+size_t CliCommand::getCmdCnt(void) {
+    return cliCmdTabCnt;
+}
+
+size_t CliCommand::getDropCnt(void) {
+    return 0;
+}
+
+#endif /* CLI_CMDTAB_STATIC == 0 */
+
+/**
+ * @brief Used to compare a command name with a given name which is not null
+ * terminated. 
+ * 
+ * The result has the same sign as strcmp() would return if the given name
+ * would be null terminated, so it matches the order used by sortTable().
+ */
+static int nameCompare(const char* cmdName, const char* name, size_t len) {
+    int ret = strncmp(cmdName, name, len);
+
+    if (ret == 0 && cmdName[len] != '\0') {
+        /* The given name is a prefix of the command name */
+        ret = 1;
+    }
+
+    return ret;
+}
+
+const cliCmd_t* CliCommand::find(const char* name, size_t len) {
+    const cliCmd_t *pTab = getTable();
+    size_t cnt = getCmdCnt();
+
+    if (name == nullptr || len == 0) {
+        /* Empty commands never match */
+        return nullptr;
+    }
+
+    if (isSorted()) {
+        return find(pTab, cnt, name, len);
+    }
+
+    for (size_t i = 0; i < cnt; i++) {
+        if (nameCompare(pTab[i].name, name, len) == 0) {
+            return &pTab[i];
         }
     }
 
     return nullptr;
 }
 
+const cliCmd_t* CliCommand::find(const cliCmd_t* pTab, size_t cnt,
+                                 const char* name, size_t len) {
+    /* Lower bound search, so the first of equally named entries is found
+     * just like the linear search above does. */
+    size_t lo = 0;
+    size_t hi = cnt;
+
+    if (name == nullptr || len == 0) {
+        return nullptr;
+    }
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+
+        if (nameCompare(pTab[mid].name, name, len) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    if (lo < cnt && nameCompare(pTab[lo].name, name, len) == 0) {
+        return &pTab[lo];
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Used to find the first entry of the sorted table in the range lo to
+ * hi which does not compare less (upper == false) or greater (upper == true)
+ * than the given prefix, when only comparing up to the length of the prefix.
+ */
+static size_t prefixBound(const cliCmd_t* pTab, size_t lo, size_t hi,
+                          const char* prefix, size_t len, bool upper) {
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int ret = strncmp(pTab[mid].name, prefix, len);
+
+        if (ret < 0 || (upper && ret == 0)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+bool CliCommand::isSorted(const cliCmd_t* pTab) {
+    /* Only the registered command table may be unsorted, the tables of
+     * groups are verified at compile time */
+    return pTab != getTable() || isSorted();
+}
+
+const cliCmd_t* CliCommand::resolve(const cliCmd_t* pTab, size_t cnt,
+                                    const char* name, size_t len,
+                                    size_t& first, size_t& matches) {
+    const cliCmd_t *pCmd = isSorted(pTab) ? find(pTab, cnt, name, len) :
+        find(name, len);
+
+    first = pCmd != nullptr ? pCmd - pTab : 0;
+    matches = pCmd != nullptr ? 1 : 0;
+
+#if CLI_PREFIX_MATCH != 0
+    if (pCmd == nullptr && len > 0) {
+        /* All names starting with the given one are counted, in a sorted
+         * table they are one range, so this tells if the abbreviation is
+         * unique. */
+        matches = findPrefix(pTab, name, len, first, cnt);
+        if (matches == 1) {
+            pCmd = &pTab[first];
+        }
+    }
+#endif
+
+    return pCmd;
+}
+
+size_t CliCommand::findPrefix(const char* prefix, size_t len, size_t& first) {
+    first = 0;
+    return findPrefix(prefix, len, first, getCmdCnt());
+}
+
+size_t CliCommand::findPrefix(const char* prefix, size_t len, size_t& first,
+                              size_t cnt) {
+    return findPrefix(getTable(), prefix, len, first, cnt);
+}
+
+size_t CliCommand::findPrefix(const cliCmd_t* pTab, const char* prefix,
+                              size_t len, size_t& first, size_t cnt) {
+    size_t end = first + cnt;
+
+    if (!isSorted(pTab)) {
+        /* Sorting here would override begin(..., false) and reset the
+         * statistics, so the unsorted table is scanned like by find() */
+        size_t matches = 0;
+
+        for (size_t i = first; i < end; i++) {
+            if (strncmp(pTab[i].name, prefix, len) == 0) {
+                first = matches == 0 ? i : first;
+                matches++;
+            }
+        }
+
+        return matches;
+    }
+
+    first = prefixBound(pTab, first, end, prefix, len, false);
+    return prefixBound(pTab, first, end, prefix, len, true) - first;
+}
+
+CmdFuncPtr CliCommand::getCmd(const char* name) {
+    const cliCmd_t *pCmd = find(name, name != nullptr ? strlen(name) : 0);
+
+    return pCmd != nullptr ? pCmd->pfunc : nullptr;
+}
+
+#if CLI_CMD_STATS != 0
+/**
+ * @brief Used to record the execution time of a call of the given command.
+ * The call itself is only counted if the command has finished.
+ */
+static void recordStats(cliCmdStats_t *pStats, uint32_t time, int8_t ret,
+                        bool done) {
+    if (done) {
+        pStats->calls++;
+        if (ret != 0) {
+            pStats->fails++;
+        }
+    }
+    pStats->total += time;
+    if (time > pStats->max) {
+        pStats->max = time;
+    }
+    pStats->last = time;
+}
+#endif
+
+void CliCommand::reject(void) {
+    Rejected = true;
+}
+
+bool CliCommand::takeRejected(void) {
+    bool ret = Rejected;
+
+    Rejected = false;
+    return ret;
+}
+
+int8_t CliCommand::invoke(const cliCmd_t* pCmd, Stream& ioStream,
+                          const char* argv[], uint8_t argc) {
+#if CLI_CMD_TASKS != 0
+    if (pCmd->ptask != nullptr) {
+        /* Nobody is going to call it again later on, so run it to the end */
+        cliTaskCtx_t ctx = {0, 0, nullptr};
+        int8_t ret;
+
+        do {
+            ret = resume(pCmd, ioStream, argv, argc, ctx);
+        } while (ret == CLI_CMD_BUSY);
+
+        return ret;
+    }
+#endif
+
+    Rejected = false;
+
+#if CLI_CMD_STATS != 0
+    uint32_t start = CLI_CMD_STATS_TIMER();
+    int8_t ret = pCmd->pfunc(ioStream, argv, argc);
+
+    recordStats(&CmdStats[pCmd - getTable()], CLI_CMD_STATS_TIMER() - start,
+        ret, true);
+
+    return ret;
+#else
+    return pCmd->pfunc(ioStream, argv, argc);
+#endif
+}
+
+#if CLI_CMD_TASKS != 0
+
+int8_t CliCommand::resume(const cliCmd_t* pCmd, Stream& ioStream,
+                          const char* argv[], uint8_t argc, cliTaskCtx_t& ctx) {
+    Rejected = false;
+
+#if CLI_CMD_STATS != 0
+    uint32_t start = CLI_CMD_STATS_TIMER();
+    int8_t ret = pCmd->ptask(ioStream, argv, argc, ctx);
+
+    recordStats(&CmdStats[pCmd - getTable()], CLI_CMD_STATS_TIMER() - start,
+        ret, ret != CLI_CMD_BUSY);
+#else
+    int8_t ret = pCmd->ptask(ioStream, argv, argc, ctx);
+#endif
+
+    ctx.call++;
+    return ret;
+}
+
+#endif
+
 int8_t CliCommand::exec(Stream& ioStream, const char* name, const char* argv[],
                         uint8_t argc) {
-    CmdFuncPtr pFunc = getCmd(name);
+    const cliCmd_t *pCmd = find(name, name != nullptr ? strlen(name) : 0);
 
-    if (pFunc != nullptr) {
-        return pFunc(ioStream, argv, argc);
+    if (pCmd != nullptr) {
+        return invoke(pCmd, ioStream, argv, argc);
     }
 
     return -1;
 }
+
+#if CLI_SUBCOMMANDS != 0
+
+int8_t CliCommand::dispatchSub(const cliCmdGroup_t& group, Stream& ioStream,
+                               const char* argv[], uint8_t argc) {
+    const cliCmd_t *pCmd = nullptr;
+    size_t first = 0;
+    size_t matches = group.cnt;
+
+    if (argc > 0) {
+        pCmd = resolve(group.pTab, group.cnt, argv[0], strlen(argv[0]),
+            first, matches);
+    }
+
+    if (pCmd == nullptr) {
+        if (argc == 0) {
+            ioStream.printf("Error, missing subcommand\n");
+        } else if (matches > 1) {
+            ioStream.printf("Error, ambiguous subcommand: %s\n", argv[0]);
+        } else {
+            ioStream.printf("Error, unknown subcommand: %s\n", argv[0]);
+            first = 0;
+            matches = group.cnt;
+        }
+
+        /* All of them or the ones matching the ambiguous abbreviation */
+        ioStream.printf("Subcommands:");
+        for (size_t i = first; i < first + matches; i++) {
+            ioStream.printf(" %s", group.pTab[i].name);
+        }
+        ioStream.printf("\n");
+
+        /* The message is already printed, see Cli::dispatch() */
+        reject();
+        return INT8_MIN;
+    }
+
+    /* The subcommand gets the remaining arguments like a command does */
+    return pCmd->pfunc(ioStream, &argv[1], argc - 1);
+}
+
+#endif
+
+#if CLI_CMD_STATS != 0
+
+const cliCmdStats_t* CliCommand::getStats(size_t idx) {
+    if (idx >= getCmdCnt()) {
+        return nullptr;
+    }
+
+    return &CmdStats[idx];
+}
+
+void CliCommand::resetStats(void) {
+    memset(CmdStats, 0, getCmdCnt() * sizeof(cliCmdStats_t));
+}
+
+#if CLI_CMD_STATS_COMMAND != 0
+
+#if CLI_CMDTAB_STATIC == 0
+CLI_COMMAND(cmdstat)
+#else
+CLI_COMMAND_DEF(cmdstat)
+#endif
+{
+    const cliCmd_t *pTab = CliCommand::getTable();
+    size_t cnt = CliCommand::getCmdCnt();
+
+    if (argc > 0) {
+        if (strcmp(argv[0], "reset") == 0) {
+            CliCommand::resetStats();
+            return 0;
+        }
+
+        ioStream.printf("Usage: cmdstat [reset]\n");
+        return -1;
+    }
+
+    ioStream.printf("%-16s %10s %10s %10s %10s %10s\n", 
+        "command", "calls", "fails", "total", "max", "last");
+
+    for (size_t i = 0; i < cnt; i++) {
+        const cliCmdStats_t *pStats = CliCommand::getStats(i);
+
+        ioStream.printf("%-16s %10lu %10lu %10lu %10lu %10lu\n", pTab[i].name,
+            (unsigned long) pStats->calls, (unsigned long) pStats->fails,
+            (unsigned long) pStats->total, (unsigned long) pStats->max, 
+            (unsigned long) pStats->last);
+    }
+
+    return 0;
+}
+
+#endif /* CLI_CMD_STATS_COMMAND != 0 */
+
+#endif /* CLI_CMD_STATS != 0 */
@@ -26,68 +26,90 @@
 #include <Arduino.h>
 #include "cli/cli.hpp"
 #include "cli/ascii.hpp"
+#include "cli/vt100.hpp"
 
 #if CLI_TAB_COMPLETION != 0
 
-uint8_t Cli::findMatchingCommands(const char* matches[]) {
-    uint8_t matchCount = 0;
+bool Cli::completionLevel(const cliCmd_t*& pTab, size_t& cnt, uint8_t& start) {
+    pTab = CliCommand::getTable();
+    cnt = CliCommand::getCmdCnt();
+    start = 0;
 
-    for (uint8_t i = 0; i < CmdTabSiz; i++) {
-        if (strncmp(pCmdTab[i].name, Buffer, BufIdx) == 0) {
-            matches[matchCount++] = pCmdTab[i].name;
+#if CLI_SUBCOMMANDS != 0
+    /* Each complete token has to be a group, the last one has to contain the
+     * subcommand which is completed. */
+    for (uint8_t i = 0; i < BufIdx; i++) {
+        const cliCmd_t *pCmd;
+        size_t first;
+        size_t matches;
+
+        if (Buffer[i] != ascii.argsep) {
+            continue;
+        }
+
+        pCmd = CliCommand::resolve(pTab, cnt, &Buffer[start], i - start,
+            first, matches);
+        if (pCmd == nullptr || pCmd->pSub == nullptr) {
+            return false;
         }
+
+        while (i + 1 < BufIdx && Buffer[i + 1] == ascii.argsep) {
+            i++;
+        }
+
+        pTab = pCmd->pSub->pTab;
+        cnt = pCmd->pSub->cnt;
+        start = i + 1;
     }
+#endif
 
-    return matchCount;
+    return true;
 }
 
 void Cli::completeMatch(const char* match, uint8_t len, bool addSpace) {
-    while(BufIdx < len && BufIdx < (CLI_COMMANDSIZ - 1)) {
-        Buffer[BufIdx] = match[BufIdx];
-        if (EchoEnabled) {
-            pStream->write(match[BufIdx]);
-        }
+    uint8_t start = BufIdx;
+    unsigned end = TabStart + len;
+
+    while(BufIdx < end && BufIdx < (CLI_COMMANDSIZ - 1)) {
+        Buffer[BufIdx] = match[BufIdx - TabStart];
         BufIdx++;
     }
     
     /* Add a space after the completed command if requested and there's room */
     if (addSpace && BufIdx < (CLI_COMMANDSIZ - 1)) {
         Buffer[BufIdx++] = ascii.argsep;
-        if (EchoEnabled) {
-            pStream->write(ascii.argsep);
-        }
     }
 
-    cli_fflush();
+    /* Echo the completed part at once */
+    if (EchoEnabled) {
+        txWrite(&Buffer[start], BufIdx - start);
+    }
+    CurIdx = BufIdx;
 }
 
-void Cli::completeToCommonPrefix(const char* matches[], uint8_t matchCount) {
-    uint8_t commonLen = BufIdx;
+void Cli::completeToCommonPrefix(size_t first, size_t matchCount) {
+    const char *pFirst = pTabCmds[first].name;
+    uint8_t curLen = BufIdx - TabStart;
+    uint8_t commonLen = UINT8_MAX;
+    size_t n = 1;
 
-    /* Find length of common prefix among all matches */
-    while (true) {
-        char refChar = matches[0][commonLen];
+    if (CliCommand::isSorted(pTabCmds)) {
+        /* The matches are sorted, so every character the first and the last
+         * match have in common is shared by all matches in between as well. */
+        n = matchCount - 1;
+    }
 
-        if (refChar == '\0') {
-            /* We've reached the end of the first match, so the common prefix 
-             * can't be longer than this. */
-            break; 
-        }
+    for (; n < matchCount; n++) {
+        const char *pOther = tabMatch(first, n)->name;
+        uint8_t len = curLen;
 
-        for (uint8_t i = 1; i < matchCount; i++) {
-            char testChar = matches[i][commonLen];
-            if (testChar == '\0' || testChar != refChar) {
-                /* Either we've reached the end of this match, or it differs 
-                 * from the first match at this position. Either way, we've 
-                 * found a difference and are done. */
-                goto out;
-            }
+        while (len < commonLen && pFirst[len] != '\0' &&
+               pFirst[len] == pOther[len]) {
+            len++;
         }
-
-        commonLen++;
+        commonLen = len;
     }
 
-    out:
     /* Only complete if there is actually a longer common prefix to add.
      * commonLen can equal BufIdx in two cases:
      * 1. Matches differ immediately after current input (e.g., "dummy_" with 
@@ -95,28 +117,28 @@ void Cli::completeToCommonPrefix(const char* matches[], uint8_t matchCount) {
      * 2. One match is exactly as long as the current input (e.g., "led" when
      *    a command named "led" exists alongside "led_on", "led_off")
      * In both cases, there's nothing to complete. */
-    if (commonLen > BufIdx) {
-        /* using matches[0] is perfectly fine as all matches share the 
+    if (commonLen > curLen) {
+        /* using the first match is perfectly fine as all matches share the 
          * common prefix and it must be part of this match */
-        completeMatch(matches[0], commonLen, false);
+        completeMatch(pFirst, commonLen, false);
     }
 }
 
-void Cli::displayMatchList(const char* matches[], uint8_t matchCount) {
+void Cli::displayMatchList(size_t first, size_t matchCount) {
     /* Display matches in aligned columns, similar to bash completion.
      * Uses column-wise layout (filling down first, then right) rather than
      * row-wise. This makes it easier to scan sorted lists vertically for
      * similar command names. */
     
     const uint8_t spacing = 3;  /* Minimum spaces between columns */
-    uint8_t maxLen = 0;
-    uint8_t colWidth = 0;
-    uint8_t numCols = 0;
-    uint8_t numRows = 0;
+    size_t maxLen = 0;
+    size_t colWidth = 0;
+    size_t numCols = 0;
+    size_t numRows = 0;
 
     /* Find the longest match to determine column width */
-    for (uint8_t i = 0; i < matchCount; i++) {
-        uint8_t len = strlen(matches[i]);
+    for (size_t i = 0; i < matchCount; i++) {
+        size_t len = strlen(tabMatch(first, i)->name);
         if (len > maxLen) {
             maxLen = len;
         }
@@ -132,36 +154,95 @@ void Cli::displayMatchList(const char* matches[], uint8_t matchCount) {
     numRows = (matchCount + numCols - 1) / numCols;
     
     /* Output matches column-wise: iterate rows, then columns */
-    pStream->write(ascii.newline);
-    for (uint8_t row = 0; row < numRows; row++) {
-        for (uint8_t col = 0; col < numCols; col++) {
+    txWrite(ascii.newline);
+    for (size_t row = 0; row < numRows; row++) {
+        for (size_t col = 0; col < numCols; col++) {
             /* Calculate index: column-wise means idx = row + col * numRows */
-            uint8_t idx = row + col * numRows;
+            size_t idx = row + col * numRows;
             
             /* Check if this cell has a valid match. The last row may be 
              * incomplete */
             if (idx < matchCount) {
-                pStream->printf("%s", matches[idx]); 
+                const char *name = tabMatch(first, idx)->name;
+
+                txWrite(name);
                 /* Add padding to align columns, except for last column */
                 if (col < numCols - 1 && idx + numRows < matchCount) {
-                    uint8_t len = strlen(matches[idx]);
-                    uint8_t padding = colWidth - len;
-                    for (uint8_t j = 0; j < padding; j++) {
-                        pStream->write(' ');
+                    size_t len = strlen(name);
+                    size_t padding = colWidth - len;
+                    for (size_t j = 0; j < padding; j++) {
+                        txWrite(' ');
                     }
                 }
             }
         }
-        pStream->write(ascii.newline);
+        txWrite(ascii.newline);
     }
     
     refreshPrompt();
 }
 
+const cliCmd_t* Cli::tabMatch(size_t first, size_t n) {
+    const char *prefix = pTabCmds[first].name;
+    size_t len = TabLen - TabStart;
+    size_t i = first;
+
+    if (CliCommand::isSorted(pTabCmds)) {
+        return &pTabCmds[first + n];
+    }
+
+    /* The command table is not sorted, see CliCommand::findPrefix(). There
+     * are at least n + 1 matches, so the loop ends within the table. */
+    while (true) {
+        if (strncmp(pTabCmds[i].name, prefix, len) == 0) {
+            if (n == 0) {
+                return &pTabCmds[i];
+            }
+            n--;
+        }
+        i++;
+    }
+}
+
+#if CLI_TAB_CYCLE != 0
+
+void Cli::replaceSuffix(const char* str, uint8_t len) {
+    char *pBuf = &Buffer[TabStart];
+    uint8_t cur = BufIdx - TabStart;
+    uint8_t common = 0;
+
+    if (len > CLI_COMMANDSIZ - 1 - TabStart) {
+        len = CLI_COMMANDSIZ - 1 - TabStart;
+    }
+
+    /* Keep what the old and the new content have in common */
+    while (common < cur && common < len && pBuf[common] == str[common]) {
+        common++;
+    }
+
+    if (EchoEnabled) {
+        if (cur > common) {
+            /* Move the cursor back and erase the old suffix */
+            cursorBack(cur - common);
+            txWrite(vt100.clreol);
+        }
+        txWrite(&str[common], len - common);
+    }
+
+    memcpy(&pBuf[common], &str[common], len - common);
+    BufIdx = TabStart + len;
+    CurIdx = BufIdx;
+}
+
+#endif /* CLI_TAB_CYCLE != 0 */
+
 void Cli::handleTabCompletion(void) {
-    const char* matches[CLI_COMMANDS_MAX];
-    uint8_t matchCount = 0;
+    const cliCmd_t *pTab;
+    size_t cnt;
+    uint8_t start;
+    bool repeat = TabRepeat;
 
+    TabRepeat = false;
     if (BufIdx == 0) {
         /* No input yet, nothing to complete. What could be done is to show all 
          * available commands. Maybe a future enhancement. */
@@ -169,24 +250,85 @@ void Cli::handleTabCompletion(void) {
         return;
     }
 
-    /* Terminate the buffer for string comparisons done by findMatchingCommands.
-     * This is ok as any further input of the user or completion will overwrite 
-     * this null terminator. */
-    Buffer[BufIdx] = '\0';
-    matchCount = findMatchingCommands(matches);
+#if CLI_TAB_CYCLE != 0
+    if (repeat && TabCnt > 1) {
+        /* Show the next match, after the last one the common prefix again */
+        TabCur = TabCur < TabCnt ? TabCur + 1 : 0;
+        if (TabCur < TabCnt) {
+            const char *match = tabMatch(TabFirst, TabCur)->name;
+            replaceSuffix(match, strlen(match));
+        } else {
+            replaceSuffix(pTabCmds[TabFirst].name, TabBase - TabStart);
+        }
+
+        TabRepeat = true;
+        return;
+    }
+#endif
+
+    if (!completionLevel(pTab, cnt, start)) {
+        /* Not a group or unknown, so there is nothing to complete */
+        sendBell();
+        TabCnt = 0;
+        return;
+    }
+
+    if (TabCnt != 0 && pTab == pTabCmds && start == TabStart &&
+        BufIdx >= TabLen && strncmp(pTab[TabFirst].name, &Buffer[start],
+        TabLen - start) == 0) {
+        /* The input still starts with the last completed prefix, so all
+         * matches are part of the previous result. */
+        if (BufIdx > TabLen) {
+            /* In the unsorted command table the matches are spread up to its
+             * end, see CliCommand::findPrefix() */
+            size_t range = CliCommand::isSorted(pTab) ? TabCnt : cnt - TabFirst;
 
-    if (matchCount == 0) {
+            TabCnt = CliCommand::findPrefix(pTab, &Buffer[start],
+                BufIdx - start, TabFirst, range);
+        } else if (repeat) {
+            /* Nothing has changed since the matches have been listed, so
+             * there is nothing more to complete. List them again, like a
+             * double Tab does in bash. */
+            displayMatchList(TabFirst, TabCnt);
+            TabRepeat = true;
+            return;
+        }
+    } else {
+        /* All matches are one range of the sorted table, no need to collect
+         * them. An unsorted command table is scanned instead. */
+        pTabCmds = pTab;
+        TabStart = start;
+        TabFirst = 0;
+        TabCnt = CliCommand::findPrefix(pTab, &Buffer[start], BufIdx - start,
+            TabFirst, cnt);
+    }
+
+    /* The input is a prefix of all matches, see tabMatch() */
+    TabLen = BufIdx;
+
+    if (TabCnt == 0) {
         /* No matches found */
         sendBell();
-    } else if (matchCount == 1) {
+    } else if (TabCnt == 1) {
         /* Exactly one match, complete it and add a space */
-        completeMatch(matches[0], strlen(matches[0]), true);
+        const char *match = pTabCmds[TabFirst].name;
+        completeMatch(match, strlen(match), true);
+        /* The completed input does not match any more, start over next time */
+        TabCnt = 0;
     } else {
         /* Multiple matches, complete to the longest common prefix */
-        completeToCommonPrefix(matches, matchCount);                
+        completeToCommonPrefix(TabFirst, TabCnt);                
+        TabLen = BufIdx;
         /* There is more than one match possible, show the list */
-        displayMatchList(matches, matchCount);
+        displayMatchList(TabFirst, TabCnt);
+        TabRepeat = true;
+#if CLI_TAB_CYCLE != 0
+        TabCur = TabCnt;
+        TabBase = BufIdx;
+#endif
     }
+
+    TabLen = BufIdx;
 }
 
 #else /* CLI_TAB_COMPLETION != 0 */
@@ -0,0 +1,237 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+#include <string.h>
+
+#include <Arduino.h>
+#include "cli/cli.hpp"
+#include "cli/ascii.hpp"
+
+#if CLI_FRAMED != 0
+
+/**
+ * @brief The output of the command of a request frame. Only used while the
+ * command is executed, which is never done by two sessions at the same time.
+ */
+static char FrameOut[CLI_FRAME_OUTSIZ];
+
+/**
+ * @brief Used to calculate a CRC-16/CCITT (polynomial 0x1021, initial value
+ * 0xFFFF) over the given data. Continuing the calculation over the CRC in big
+ * endian order results in zero.
+ */
+static uint16_t crc16(uint16_t crc, const void *data, size_t len) {
+    const uint8_t *pData = (const uint8_t *) data;
+
+    while (len--) {
+        crc ^= (uint16_t) (*pData++) << 8;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) :
+                                   (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+size_t CliCapture::write(uint8_t byte) {
+    return write(&byte, 1);
+}
+
+size_t CliCapture::write(const uint8_t *buf, size_t len) {
+    if (len > Size - Len) {
+        len = Size - Len;
+        Truncated = true;
+    }
+
+    memcpy(&pBuf[Len], buf, len);
+    Len += len;
+
+    return len;
+}
+
+bool Cli::handleFrame(char byte, int8_t &ret) {
+    uint8_t value = (uint8_t) byte;
+
+    FrameTime = millis();
+    switch (FrameState) {
+        case frame_start:
+            if (byte != ascii.stx) {
+                /* Not a frame, the byte is processed as usual */
+                dropFrame();
+                return false;
+            }
+            FrameCrc = 0xFFFF;
+            FrameState = frame_seq;
+            break;
+
+        case frame_seq:
+            FrameSeq = value;
+            FrameCrc = crc16(FrameCrc, &value, 1);
+            FrameState = frame_len;
+            break;
+
+        case frame_len:
+            FrameLen = value;
+            FrameIdx = 0;
+            FrameCrc = crc16(FrameCrc, &value, 1);
+            FrameState = (FrameLen > 0) ? frame_data : frame_crc_hi;
+            break;
+
+        case frame_data:
+            frameData(&byte, 1);
+            break;
+
+        case frame_crc_hi:
+            FrameCrc = crc16(FrameCrc, &value, 1);
+            FrameState = frame_crc_lo;
+            break;
+
+        case frame_crc_lo:
+            FrameCrc = crc16(FrameCrc, &value, 1);
+            FrameState = frame_idle;
+            ret = execFrame(FrameCrc == 0);
+            break;
+
+        default:
+            FrameState = frame_idle;
+            return false;
+    }
+
+    return true;
+}
+
+void Cli::expireFrame(void) {
+#if CLI_FRAME_TIMEOUT > 0
+    if ((uint32_t) (millis() - FrameTime) > CLI_FRAME_TIMEOUT) {
+        /* The rest of the frame is not going to arrive, e.g. the host has
+         * been restarted. Otherwise its length would swallow further input. */
+        dropFrame();
+    }
+#endif
+}
+
+void Cli::dropFrame(void) {
+    if (FrameState == frame_start) {
+        if (BufIdx < (CLI_COMMANDSIZ - 1)) {
+            insert(&ascii.dle, 1);
+        } else {
+            sendBell();
+        }
+    }
+
+    FrameState = frame_idle;
+}
+
+size_t Cli::frameData(const char *data, size_t len) {
+    size_t missing = FrameLen - FrameIdx;
+    const char *dle = nullptr;
+
+    if (len > missing) {
+        len = missing;
+    }
+
+    FrameTime = millis();
+    dle = (const char *) memchr(data, ascii.dle, len);
+    if (dle != nullptr) {
+        /* The host has given up on the partial frame and starts a new one */
+        FrameState = frame_start;
+        return (size_t) (dle - data) + 1;
+    }
+
+    FrameCrc = crc16(FrameCrc, data, len);
+
+    /* A command line which is too long is received and checked anyway, but
+     * not stored */
+    if (FrameLen < sizeof(FrameBuf)) {
+        memcpy(&FrameBuf[FrameIdx], data, len);
+    }
+
+    FrameIdx += (uint8_t) len;
+    if (FrameIdx == FrameLen) {
+        FrameState = frame_crc_hi;
+    }
+
+    return len;
+}
+
+int8_t Cli::execFrame(bool valid) {
+    CliCapture capture(FrameOut, sizeof(FrameOut));
+    Stream *pIoStr = pStream;
+    int8_t ret = INT8_MIN;
+    uint8_t flags = 0;
+    char hdr[7];
+    char crc[2];
+    uint16_t len = 0;
+
+    if (!valid) {
+        flags |= CLI_FRAME_CRC_ERROR;
+    } else if (FrameLen >= sizeof(FrameBuf)) {
+        flags |= CLI_FRAME_TOO_LONG;
+    } else {
+        /* All output while the command is executed, including error messages
+         * of the library, is part of the response */
+        txDrain();
+        pStream = &capture;
+        ret = execLine(FrameBuf, FrameLen);
+        txDrain();
+        pStream = pIoStr;
+
+        if (capture.isTruncated()) {
+            flags |= CLI_FRAME_TRUNCATED;
+        }
+    }
+
+    len = (uint16_t) capture.length();
+    hdr[0] = ascii.dle;
+    hdr[1] = ascii.stx;
+    hdr[2] = (char) FrameSeq;
+    hdr[3] = (char) ret;
+    hdr[4] = (char) flags;
+    hdr[5] = (char) (len >> 8);
+    hdr[6] = (char) (len & 0xFF);
+
+    FrameCrc = crc16(0xFFFF, &hdr[2], sizeof(hdr) - 2);
+    FrameCrc = crc16(FrameCrc, capture.data(), len);
+    crc[0] = (char) (FrameCrc >> 8);
+    crc[1] = (char) (FrameCrc & 0xFF);
+
+#if CLI_TX_NONBLOCK != 0
+    /* The queue drops what does not fit, but a response frame cut short
+     * desyncs the host. So it is written blocking like the output of a
+     * command, after the queued output to keep the order. */
+    txDrain();
+    pStream->write(hdr, sizeof(hdr));
+    pStream->write(capture.data(), len);
+    pStream->write(crc, sizeof(crc));
+#else
+    txWrite(hdr, sizeof(hdr));
+    txWrite(capture.data(), len);
+    txWrite(crc, sizeof(crc));
+#endif
+
+    return ret;
+}
+
+#endif
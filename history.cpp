@@ -23,13 +23,19 @@
  */
 
 #include "cli/history.hpp"
+#include "cli/journal.hpp"
 #include "string.h"
 
 #if CLI_HISTORYSIZ > 0
 
 CliHistory::CliHistory(void) {
-    is_used = false;
-    memset(Buffer, 0, sizeof(Buffer));
+    /* No need to memset the buffer, clear() takes care that no byte is read
+     * before it has been written. This keeps the constructor, which runs
+     * before main(), cheap even for a large CLI_HISTORYSIZ. */
+    Seq = 0;
+#if CLI_HISTORY_JOURNAL != 0
+    pJournal = nullptr;
+#endif
     clear();
 }
 
@@ -37,6 +43,8 @@ CliHistory::~CliHistory(void) {
 }
 
 bool CliHistory::append(const char *str, size_t len) {
+    size_t first = 0;
+
     if (str == nullptr || len == 0 ||
         len > sizeof(Buffer) - 1 ||
         str[len] != '\0') {
@@ -45,188 +53,226 @@ bool CliHistory::append(const char *str, size_t len) {
 
     /* Check if the new string is identical to the last added entry to avoid
      * duplicate consecutive entries in the history */
-    if (pLast != 0) {
-        char *pTemp = pLast;
-        const char *pStr = str;
-        bool identical = true;
-
-        /* Compare character by character, handling wrap-around */
-        for (size_t i = 0; i < len; i++) {
-            if (*pTemp != *pStr) {
-                identical = false;
-                break;
-            }
-            increment_position(pTemp);
-            pStr++;
-        }
-
-        /* Check if we reached the null terminator at pTemp */
-        if (identical && *pTemp == '\0') {
-            /* Strings are identical, no need to append */
-            reset_navigation();
-            return true;
-        }
+    if (Count != 0 && line_len(1) == len && equals(Index[slot(1)], str, len)) {
+        /* Strings are identical, no need to append */
+        return true;
     }
 
-    while (get_free_space() < len + 1) {
-        /* Just for safety, This should not happen, as get_free_space should
-         * return sizeof(Buffer) in this case */
-        if (pTail == 0) {
-            return false;
-        }
-
-        /* find the next null terminator and set the tail to the next byte as
-         * this is the start of the next line */
-        while (*pTail != '\0') {
-            increment_position(pTail);
-        }
-        increment_position(pTail);
-
-        /* if tail and head are now equal, the buffer is empty. Reset to a clean
-         * state as safety measure */
-        if (pTail == pHead) {
-            clear();
+    /* Remove the oldest lines until the new line fits and a free index entry
+     * is available. The start of the next line is known from the index, so
+     * each removal is O(1). */
+    while (Count == CLI_HISTORY_ENTRIES || get_free_space() < len + 1) {
+        First = First + 1 < CLI_HISTORY_ENTRIES ? First + 1 : 0;
+        Count--;
+
+        /* if the buffer is now empty, reset to a clean state as safety
+         * measure */
+        if (Count == 0) {
+            Head = 0;
+            First = 0;
         }
     }
 
-    /* Read and Tail can be set now as needed and the new line can be written.
-     * By incrementing the length by one, we also write the null terminator of
-     * the line, without the need to handle it as special case.
+    /* The new line can be written now, in up to two segments around the end
+     * of the buffer. By copying one byte more, we also write the null
+     * terminator of the line, without the need to handle it as special case.
      */
-    pLast = pHead;
-    pTail = pTail == 0 ? pHead : pTail;
-    len++;
-    while (len > 0) {
-        size_t space_to_end = sizeof(Buffer) - (pHead - Buffer);
-        size_t to_write = (len < space_to_end) ? len : space_to_end;
-
-        memcpy(pHead, str, to_write);
-        increment_position(pHead, to_write);
-        str += to_write;
-        len -= to_write;
+    Count++;
+    Index[slot(1)] = Head;
+    Seq++;
+
+    first = segment(Head, len + 1);
+    memcpy(&Buffer[Head], str, first);
+    memcpy(Buffer, str + first, len + 1 - first);
+    Head = increment_position(Head, len + 1);
+
+#if CLI_HISTORY_JOURNAL != 0
+    if (pJournal != nullptr) {
+        pJournal->append(*this, str, len);
     }
+#endif
 
-    reset_navigation();
     return true;
 }
 
-bool CliHistory::seek_backward(void) {
-    /* Currently the read pointer points to line n, what we want is to set it to
-     * line n-1 if it exists */
-    char *pTemp = pRead;
+void CliHistory::rewind(cursor_t &cur) {
+    cur.seq = Seq - 1;
+    cur.is_used = false;
+}
 
-    if (pTemp == 0 || pTemp == pTail) {
-        /* If the read pointer is equal to the tail it allready points to the
-         * oldest line, it is zero, the buffer is empty, however can't move
-         * backward */
+bool CliHistory::seek(cursor_t &cur, size_t n) {
+    if (n >= Count) {
         return false;
     }
 
-    /* below the current position is the null terminator of line n-1, pass it
-     * directly to start looking for the null terminator of line n-2 or the tail
-     * if line n-1 is the oldest line in the buffer */
-    decrement_position(pTemp, 2);
-
-    while (*pTemp != '\0') {
-        if (pTemp == pTail) {
-            /* The previous line is the oldest line in the buffer and we don't
-             * need to seek further, we are done */
-            pRead = pTail;
-            return true;
-        }
-        decrement_position(pTemp);
-    }
-
-    /* Found the null terminator of the line n-2, set the read pointer to
-     * the start of the line n-1 which is the next byte in forward direction */
-    increment_position(pTemp);
-    pRead = pTemp;
+    cur.seq = Seq - 1 - n;
     return true;
 }
 
-bool CliHistory::seek_forward(void) {
-    /* Currently the read pointer points to line n, what we want is to set it to
-     * line n+1 if it exists */
-    char *pTemp = pRead;
+bool CliHistory::seek_backward(cursor_t &cur) {
+    if (!is_valid(cur)) {
+        /* The line has been removed in between, e.g. by another session
+         * sharing the history. Start over at the most recent line. */
+        rewind(cur);
+        return Count != 0;
+    }
 
-    if (pTemp == 0) {
-        /* the buffer is empty */
+    if (age(cur) == Count) {
+        /* Allready at the oldest line, can't move backward */
         return false;
     }
 
-    /* Move the read pointer forward until the null terminator of line n has
-     * been found. one step further is the start of line n+1 */
-    while (*pTemp != '\0') {
-        increment_position(pTemp);
-        if (pTemp == pHead) {
-            /* Just for safety, this should not happen because there should
-             * be a null terminator at the end of every line and the head is
-             * one position past this null-terminator */
-            return false;
-        }
+    cur.seq--;
+    return true;
+}
+
+bool CliHistory::seek_forward(cursor_t &cur) {
+    if (!is_valid(cur)) {
+        /* Outdated, there is nothing more recent than the most recent line */
+        rewind(cur);
+        return false;
     }
-    increment_position(pTemp);
 
-    if (pTemp == pHead) {
-        /* Found the end of a line n but what comes next is the head, so there
-         * is no next line in the buffer, abort */
+    if (age(cur) == 1) {
+        /* Allready at the most recent line, there is no next line */
         return false;
     }
 
-    /* Update the read pointer only in case of success */
-    pRead = pTemp;
+    cur.seq++;
     return true;
 }
 
-size_t CliHistory::read(char *line, size_t len) {
+size_t CliHistory::read(cursor_t &cur, char *line, size_t len) {
     size_t numRead = 0;
-    char *pTemp = pRead;
+    size_t first = 0;
+    size_t pos = 0;
+
+    if (!is_valid(cur)) {
+        rewind(cur);
+    }
+
+    if (Count == 0 || line == nullptr) {
+        return 0;
+    }
 
-    if (pRead == 0 || line == nullptr || len == 0) {
+    numRead = line_len(age(cur));
+    if (numRead >= len) {
+        /* The provided buffer is too small to hold the line including the
+         * null terminator, abort. */
         return 0;
     }
 
-    while(*pTemp != '\0') {
-        if (len == 1) {
-            /* The provided buffer is too small to hold the line including the
-             * null terminator, abort. */
-            return 0;
+    /* Copy the part up to the end of the buffer and the wrapped rest */
+    pos = Index[slot(age(cur))];
+    first = segment(pos, numRead);
+    memcpy(line, &Buffer[pos], first);
+    memcpy(line + first, Buffer, numRead - first);
+
+    line[numRead] = '\0';
+    return numRead;
+}
+
+bool CliHistory::search(cursor_t &cur, const char *str, size_t len,
+                        bool skip) {
+    if (!is_valid(cur)) {
+        rewind(cur);
+    }
+
+    if (Count == 0 || str == nullptr || len == 0) {
+        return false;
+    }
+
+    for (size_t a = age(cur) + (skip ? 1 : 0); a <= Count; a++) {
+        size_t start = Index[slot(a)];
+        size_t llen = line_len(a);
+
+        /* Check the first character before comparing the whole pattern */
+        for (size_t i = 0; i + len <= llen; i++) {
+            size_t pos = increment_position(start, i);
+
+            if (Buffer[pos] == str[0] && equals(pos, str, len)) {
+                cur.seq = Seq - a;
+                return true;
+            }
         }
+    }
 
-        *line++ = *pTemp;
-        increment_position(pTemp);
-        len--;
-        numRead++;
+    return false;
+}
+
+size_t CliHistory::peek(cursor_t &cur, const char *seg[2], size_t seglen[2]) {
+    size_t pos = 0;
+    size_t len = 0;
+
+    if (!is_valid(cur)) {
+        rewind(cur);
     }
 
-    *line = '\0';
-    return numRead;
+    if (Count != 0) {
+        pos = Index[slot(age(cur))];
+        len = line_len(age(cur));
+    }
+
+    seg[0] = &Buffer[pos];
+    seglen[0] = segment(pos, len);
+    seg[1] = Buffer;
+    seglen[1] = len - seglen[0];
+    return len;
+}
+
+size_t CliHistory::line_len(size_t age) {
+    size_t start = Index[slot(age)];
+    size_t end = age > 1 ? Index[slot(age - 1)] : Head;
+    size_t len = end > start ? end - start : end + sizeof(Buffer) - start;
+
+    /* Equal offsets mean the line fills the whole buffer, which is covered
+     * by the second case above as well. Subtract the null terminator. */
+    return len - 1;
+}
+
+size_t CliHistory::get_count(void) {
+    return Count;
 }
 
 size_t CliHistory::get_free_space(void) {
-    if (pTail == 0) {
-        /* The buffer is empty, all space is free. */
+    size_t tail = 0;
+
+    if (Count == 0) {
+        /* The buffer is empty, all space is free. Index is not valid in this
+         * case, it is not cleared by the constructor. */
         return sizeof(Buffer);
-    } else if (pHead > pTail) {
+    }
+
+    tail = Index[First];
+    if (Head > tail) {
         /* The head is ahead of the tail, the free space is the space after the
          * head plus the space before the tail. */
-        return (sizeof(Buffer) - (pHead - Buffer)) + (pTail - Buffer);
-    } else if (pHead < pTail) {
+        return (sizeof(Buffer) - Head) + tail;
+    } else if (Head < tail) {
         /* The tail is ahead of the head, the free space is the space between
          * the head and the tail. */
-        return pTail - pHead;
+        return tail - Head;
     } else {
-        /* pTail != 0 but equal to pHead, the buffer is full */
+        /* Lines are stored but the head is equal to the tail, the buffer is
+         * full */
         return 0;
     }
 }
 
+#if CLI_HISTORY_JOURNAL != 0
+
+void CliHistory::set_journal(CliJournal *pJrnl) {
+    pJournal = pJrnl;
+}
+
+#endif
+
 void CliHistory::clear(void) {
-    /* a memset zero is not necessary, just reset the pointers */
-    pHead = Buffer;
-    pRead = 0;
-    pTail = 0;
-    pLast = 0;
+    /* a memset zero is not necessary, just reset the index. Seq is not reset,
+     * so all cursors become outdated. */
+    Head = 0;
+    First = 0;
+    Count = 0;
 }
 
 #endif // CLI_HISTORYSIZ > 0
\ No newline at end of file
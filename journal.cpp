@@ -0,0 +1,248 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for 
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+#include "cli/journal.hpp"
+#include "string.h"
+
+#if CLI_HISTORYSIZ > 0 && CLI_HISTORY_JOURNAL != 0
+
+/**
+ * @brief The journal header, stored at address 0.
+ */
+typedef struct {
+
+    /**
+     * @brief Identifies a valid journal, see JournalMagic.
+     */
+    uint8_t magic[4];
+
+    /**
+     * @brief The lifetime erase counter of the storage. Also used as seed of
+     * the record CRC, so records of a previous journal are not mistaken as
+     * valid if the storage has not been erased completely.
+     */
+    uint32_t erases;
+
+} journalHdr_t;
+
+/**
+ * @brief The magic bytes of the journal header, the last one is the version
+ * of the journal format.
+ */
+static const uint8_t JournalMagic[4] = {'C', 'L', 'J', 1};
+
+/**
+ * @brief The size of a record header, the length and the CRC.
+ */
+static const size_t RecordHdrSiz = 2;
+
+/**
+ * @brief Lines must be shorter than this to be stored, a length of 0xFF
+ * would look like erased storage.
+ */
+static const size_t RecordMaxLen = CLI_COMMANDSIZ < 0xFF ? CLI_COMMANDSIZ : 0xFF;
+
+/**
+ * @brief Used to calculate a CRC-8 (polynomial 0x07) over the given data.
+ */
+static uint8_t crc8(uint8_t crc, const void *data, size_t len) {
+    const uint8_t *pData = (const uint8_t *) data;
+
+    while (len--) {
+        crc ^= *pData++;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+CliJournal::CliJournal(CliJournalStorage &storage) :
+    Storage(storage),
+    End(0),
+    Dirty(true)
+{
+    memset(&Stats, 0, sizeof(Stats));
+}
+
+size_t CliJournal::restore(CliHistory &history) {
+    journalHdr_t hdr;
+    char line[CLI_COMMANDSIZ];
+    size_t cnt = 0;
+    uint8_t rec[RecordHdrSiz];
+
+    if (!Storage.read(0, &hdr, sizeof(hdr)) ||
+        memcmp(hdr.magic, JournalMagic, sizeof(hdr.magic)) != 0) {
+        /* No valid journal, start a new one. The erase counter is lost. */
+        Stats.erases = 0;
+        format();
+        return 0;
+    }
+
+    Stats.erases = hdr.erases;
+    End = sizeof(hdr);
+    Dirty = false;
+
+    /* Replay all records, the history takes care of removing old lines just
+     * like it did when the commands have been entered. */
+    while (End + RecordHdrSiz <= Storage.size()) {
+        if (!Storage.read(End, rec, sizeof(rec))) {
+            Dirty = true;
+            break;
+        }
+
+        if (rec[0] == 0xFF && rec[1] == 0xFF) {
+            /* Erased, this is the end of the journal */
+            break;
+        }
+
+        if (rec[0] == 0 || rec[0] >= RecordMaxLen ||
+            End + RecordHdrSiz + rec[0] > Storage.size() ||
+            !Storage.read(End + RecordHdrSiz, line, rec[0]) ||
+            crc8(crc8(0, &Stats.erases, sizeof(Stats.erases)), line, rec[0])
+                != rec[1]) {
+            /* A torn or stale record, the following bytes can't be trusted
+             * to be erased. */
+            Dirty = true;
+            break;
+        }
+
+        line[rec[0]] = '\0';
+        history.append(line, rec[0]);
+        End += RecordHdrSiz + rec[0];
+        cnt++;
+    }
+
+    return cnt;
+}
+
+bool CliJournal::append(CliHistory &history, const char *str, size_t len) {
+    if (len == 0 || len >= RecordMaxLen) {
+        return false;
+    }
+
+    Stats.appends++;
+    Stats.requested += len;
+
+    if (!Dirty && writeRecord(str, len)) {
+        return true;
+    }
+
+    /* The storage is full or not writable at the end, start over with the
+     * current content of the history, which allready contains this line. */
+    return compact(history);
+}
+
+cliJournalStats_t CliJournal::getStats(void) {
+    return Stats;
+}
+
+bool CliJournal::format(void) {
+    journalHdr_t hdr;
+
+    Dirty = true;
+    if (Storage.size() < sizeof(hdr) || !Storage.erase()) {
+        return false;
+    }
+
+    Stats.erases++;
+    memcpy(hdr.magic, JournalMagic, sizeof(hdr.magic));
+    hdr.erases = Stats.erases;
+    if (!Storage.write(0, &hdr, sizeof(hdr))) {
+        return false;
+    }
+
+    Stats.written += sizeof(hdr);
+    End = sizeof(hdr);
+    Dirty = false;
+    return true;
+}
+
+bool CliJournal::compact(CliHistory &history) {
+    char line[CLI_COMMANDSIZ];
+    CliHistory::cursor_t cur;
+    size_t space = 0;
+    size_t n = 0;
+
+    /* The old journal is gone from here on, see CliJournalStorage::erase().
+     * The lines are still in the history, so only a reset before they are
+     * written again loses them. */
+    Stats.compactions++;
+    if (!format()) {
+        return false;
+    }
+
+    /* Find out how many of the most recent lines fit into the storage */
+    history.rewind(cur);
+    space = Storage.size() - End;
+    while (history.seek(cur, n)) {
+        size_t len = history.read(cur, line, sizeof(line));
+
+        if (len != 0 && len < RecordMaxLen) {
+            if (len + RecordHdrSiz > space) {
+                break;
+            }
+            space -= len + RecordHdrSiz;
+        }
+        n++;
+    }
+
+    /* Write them from the oldest to the most recent line */
+    while (n > 0) {
+        n--;
+        history.seek(cur, n);
+        size_t len = history.read(cur, line, sizeof(line));
+
+        if (len != 0 && len < RecordMaxLen && !writeRecord(line, len)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool CliJournal::writeRecord(const char *str, size_t len) {
+    uint8_t rec[RecordHdrSiz];
+
+    if (End + RecordHdrSiz + len > Storage.size()) {
+        return false;
+    }
+
+    rec[0] = (uint8_t) len;
+    rec[1] = crc8(crc8(0, &Stats.erases, sizeof(Stats.erases)), str, len);
+
+    if (!Storage.write(End, rec, sizeof(rec)) ||
+        !Storage.write(End + sizeof(rec), str, len)) {
+        /* Unknown state of the storage after End */
+        Dirty = true;
+        return false;
+    }
+
+    Stats.written += sizeof(rec) + len;
+    End += sizeof(rec) + len;
+    return true;
+}
+
+#endif // CLI_HISTORYSIZ > 0 && CLI_HISTORY_JOURNAL != 0
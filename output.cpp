@@ -0,0 +1,192 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <Arduino.h>
+#include "cli/cli.hpp"
+
+#if CLI_TX_NONBLOCK != 0
+/**
+ * @brief Used to get the number of bytes, up to len, which can be written to
+ * the stream without blocking.
+ */
+static size_t writable(Stream *pStream, size_t len) {
+    int avail = pStream->availableForWrite();
+
+    if (avail <= 0) {
+        return 0;
+    }
+
+    return (size_t) avail < len ? (size_t) avail : len;
+}
+#endif
+
+void Cli::txWrite(const char *data, size_t len) {
+#if CLI_TX_NONBLOCK != 0
+    TxStats.requested++;
+
+    if (len > sizeof(TxBuf) - TxLen) {
+        /* Make room by writing what the stream takes right now and by moving
+         * the rest to the start of the queue */
+        txFlush();
+        if (TxPos > 0) {
+            memmove(TxBuf, &TxBuf[TxPos], TxLen - TxPos);
+            TxLen -= TxPos;
+            TxPos = 0;
+        }
+
+        if (TxLen == 0 && len > sizeof(TxBuf)) {
+            /* Nothing queued, so the order is maintained when writing as
+             * much as the stream takes directly */
+            size_t cnt = writable(pStream, len);
+
+            if (cnt > 0) {
+                cnt = pStream->write(data, cnt);
+                TxStats.written++;
+                data += cnt;
+                len -= cnt;
+            }
+        }
+
+        if (len > sizeof(TxBuf) - TxLen) {
+            TxStats.dropped += len - (sizeof(TxBuf) - TxLen);
+            len = sizeof(TxBuf) - TxLen;
+        }
+    }
+
+    memcpy(&TxBuf[TxLen], data, len);
+    TxLen += len;
+#elif CLI_TXBUFSIZ > 0
+    TxStats.requested++;
+
+    if (len > sizeof(TxBuf) - TxLen) {
+        txFlush();
+    }
+
+    if (len > sizeof(TxBuf)) {
+        /* Does not fit at all, the buffer has been flushed above so the order
+         * is maintained when writing it directly */
+        pStream->write(data, len);
+        TxStats.written++;
+    } else {
+        memcpy(&TxBuf[TxLen], data, len);
+        TxLen += len;
+    }
+#else
+    pStream->write(data, len);
+#endif
+
+    if (TxHold == false) {
+        txFlush();
+    }
+}
+
+void Cli::txWrite(const char *str) {
+    txWrite(str, strlen(str));
+}
+
+void Cli::txWrite(char byte) {
+    txWrite(&byte, 1);
+}
+
+void Cli::txPrintf(const char *fmt, ...) {
+    /* Only used for short messages, longer ones are truncated */
+    char buf[48];
+    va_list args;
+    int len = 0;
+
+    va_start(args, fmt);
+    len = vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+
+    if (len > 0) {
+        txWrite(buf, (size_t) len < sizeof(buf) ? len : sizeof(buf) - 1);
+    }
+}
+
+void Cli::txFlush(void) {
+#if CLI_TX_NONBLOCK != 0
+    if (TxPos < TxLen) {
+        size_t cnt = writable(pStream, TxLen - TxPos);
+
+        if (cnt < (size_t) (TxLen - TxPos)) {
+            TxStats.stalls++;
+        }
+
+        if (cnt > 0) {
+            TxPos += pStream->write(&TxBuf[TxPos], cnt);
+            TxStats.written++;
+        }
+
+        if (TxPos >= TxLen) {
+            TxPos = 0;
+            TxLen = 0;
+        }
+    }
+#elif CLI_TXBUFSIZ > 0
+    if (TxLen > 0) {
+        pStream->write(TxBuf, TxLen);
+        TxStats.written++;
+        TxLen = 0;
+    }
+#endif
+
+    cli_fflush();
+}
+
+void Cli::txDrain(void) {
+#if CLI_TX_NONBLOCK != 0
+    if (TxPos < TxLen) {
+        pStream->write(&TxBuf[TxPos], TxLen - TxPos);
+        TxStats.written++;
+        TxPos = 0;
+        TxLen = 0;
+    }
+
+    cli_fflush();
+#else
+    txFlush();
+#endif
+}
+
+bool Cli::txHold(bool hold) {
+    bool prev = TxHold;
+
+    TxHold = hold;
+    if (hold == false) {
+        txFlush();
+    }
+
+    return prev;
+}
+
+#if CLI_TXBUFSIZ > 0
+
+cliTxStats_t Cli::getTxStats(void) {
+    return TxStats;
+}
+
+#endif
@@ -0,0 +1,123 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+#include <string.h>
+#include <Arduino.h>
+#include "cli/cli.hpp"
+#include "cli/ascii.hpp"
+
+#if CLI_HISTORYSIZ > 0 && CLI_HISTORY_SEARCH > 0
+
+void Cli::startSearch(void) {
+    History.rewind(HistCur);
+    SearchLen = 0;
+    Searching = true;
+    SearchHit = false;
+    SearchFailed = false;
+    drawSearch();
+}
+
+bool Cli::handleSearch(char byte) {
+    if (isPlain(byte)) {
+        if (SearchLen == sizeof(Search)) {
+            sendBell();
+            return true;
+        }
+
+        Search[SearchLen++] = byte;
+
+        /* Lines more recent than the current match did not contain the
+         * shorter pattern, so they can't contain the longer one either. The
+         * search resumes at the current match. */
+        if (!SearchFailed) {
+            SearchFailed = !History.search(HistCur, Search, SearchLen, false);
+            SearchHit |= !SearchFailed;
+        }
+
+        if (SearchFailed) {
+            sendBell();
+        }
+    } else if (byte == ascii.dc2) {
+        /* Search for the next older match */
+        if (SearchLen == 0 || 
+            !History.search(HistCur, Search, SearchLen, SearchHit)) {
+            sendBell();
+        }
+    } else if ((byte == ascii.del) || (byte == ascii.bs)) {
+        if (SearchLen > 0) {
+            /* A more recent line may match the shorter pattern, start over */
+            SearchLen--;
+            History.rewind(HistCur);
+            SearchHit = (SearchLen > 0) &&
+                History.search(HistCur, Search, SearchLen, false);
+            SearchFailed = (SearchLen > 0) && !SearchHit;
+        } else {
+            sendBell();
+        }
+    } else if (byte == ascii.bell) {
+        /* ctrl-G, cancel the search and restore the original line */
+        Searching = false;
+        History.rewind(HistCur);
+        clearLine();
+        refreshPrompt();
+        return true;
+    } else {
+        /* Accept the match, the byte is processed as usual afterwards, e.g.
+         * enter executes the accepted line */
+        Searching = false;
+        if (SearchHit) {
+            BufIdx = (uint8_t) History.read(HistCur, Buffer, sizeof(Buffer));
+            CurIdx = BufIdx;
+            HistCur.is_used = true;
+        }
+        clearLine();
+        refreshPrompt();
+        return false;
+    }
+
+    drawSearch();
+    return true;
+}
+
+void Cli::drawSearch(void) {
+    const char *seg[2];
+    size_t seglen[2];
+
+    /* Only the search line is redrawn */
+    clearLine();
+    txWrite(SearchFailed ? "(failed reverse-i-search)`" : "(reverse-i-search)`");
+    txWrite(Search, SearchLen);
+    txWrite("': ");
+
+    if (SearchHit) {
+        /* Written directly from the history, no need to copy the line */
+        History.peek(HistCur, seg, seglen);
+        txWrite(seg[0], seglen[0]);
+        if (seglen[1] > 0) {
+            txWrite(seg[1], seglen[1]);
+        }
+    }
+}
+
+#endif /* CLI_HISTORYSIZ > 0 && CLI_HISTORY_SEARCH > 0 */
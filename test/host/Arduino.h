@@ -0,0 +1,134 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+/*
+ * Stand-in for the part of the Arduino API used by libCli, so the library can
+ * be compiled and tested on a host. See doc/HOST_BUILD.md.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * @brief Milliseconds since the first call, like millis() since reset.
+ */
+inline unsigned long millis(void) {
+    static const auto start = std::chrono::steady_clock::now();
+
+    return (unsigned long) std::chrono::duration_cast<
+        std::chrono::milliseconds>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+/**
+ * @brief Microseconds since the first call, like micros() since reset. Used
+ * by the default CLI_CMD_STATS_TIMER().
+ */
+inline unsigned long micros(void) {
+    static const auto start = std::chrono::steady_clock::now();
+
+    return (unsigned long) std::chrono::duration_cast<
+        std::chrono::microseconds>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+/**
+ * @brief Output part of a stream, same interface as the Arduino Print class.
+ */
+class Print {
+    public:
+        virtual ~Print() {}
+
+        virtual size_t write(uint8_t byte) = 0;
+
+        virtual size_t write(const uint8_t *buf, size_t len) {
+            size_t n = 0;
+
+            while (n < len && write(buf[n]) == 1) {
+                n++;
+            }
+            return n;
+        }
+
+        size_t write(const char *buf, size_t len) {
+            return write((const uint8_t *) buf, len);
+        }
+
+        size_t write(const char *str) {
+            return write(str, strlen(str));
+        }
+
+        /**
+         * @brief Same default as Arduino, a stream which does not override
+         * it never reports free space. Required by CLI_TX_NONBLOCK.
+         */
+        virtual int availableForWrite() {
+            return 0;
+        }
+
+        virtual void flush() {}
+
+        size_t printf(const char *fmt, ...) {
+            char buf[256];
+            va_list args;
+            int len = 0;
+
+            va_start(args, fmt);
+            len = vsnprintf(buf, sizeof(buf), fmt, args);
+            va_end(args);
+            return len > 0 ? write(buf, strlen(buf)) : 0;
+        }
+};
+
+/**
+ * @brief Input and output stream, same interface as the Arduino Stream class.
+ */
+class Stream : public Print {
+    public:
+        virtual int available() = 0;
+        virtual int read() = 0;
+        virtual int peek() = 0;
+
+        /**
+         * @brief Never blocks, libCli never asks for more than available().
+         */
+        size_t readBytes(char *buf, size_t len) {
+            size_t n = 0;
+            int c = 0;
+
+            while (n < len && (c = read()) >= 0) {
+                buf[n++] = (char) c;
+            }
+            return n;
+        }
+};
+
+extern Stream &Serial;
@@ -0,0 +1,83 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+/*
+ * Executes the same command line by byte wise Cli::read(), by bulk
+ * Cli::read() and by Cli::execLine(), with a stream which discards all output.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "host.hpp"
+#include "cli/cli.hpp"
+
+class NullStream : public TestStream {
+    public:
+        size_t write(const uint8_t *, size_t len) override {
+            return len;
+        }
+};
+
+static NullStream io;
+Stream &Serial = io;
+static volatile int sink = 0;
+
+CLI_COMMAND(set) {
+    sink += argc;
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    const int n = argc > 2 ? atoi(argv[2]) : 200000;
+    const char *line = "set motor7 speed 1200 accel \"100 ramp\" on\r";
+    size_t len = strlen(line);
+    Cli cli;
+
+    cli.begin(&io);
+
+    double t0 = hostNow();
+    for (int i = 0; i < n; i++) {
+        for (size_t k = 0; k < len; k++) {
+            cli.read(line[k]);
+        }
+    }
+
+    double t1 = hostNow();
+    for (int i = 0; i < n; i++) {
+        for (size_t k = 0; k < len; ) {
+            k += cli.read(&line[k], len - k);
+        }
+    }
+
+    double t2 = hostNow();
+    for (int i = 0; i < n; i++) {
+        cli.execLine(line, len);
+    }
+
+    double t3 = hostNow();
+    printf("{\"bench\":\"dispatch\",\"variant\":\"%s\",\"read_byte_ns\":%.1f,"
+        "\"read_bulk_ns\":%.1f,\"exec_line_ns\":%.1f}\n", argc > 1 ? argv[1] : "",
+        (t1 - t0) / n * 1e9, (t2 - t1) / n * 1e9, (t3 - t2) / n * 1e9);
+    return 0;
+}
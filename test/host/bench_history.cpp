@@ -0,0 +1,78 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+/*
+ * Measures history navigation, the duplicate check of CliHistory::append()
+ * and appending new lines with a 4 KB history holding 40 byte lines. Built
+ * with and without CLI_HISTORY_POW2, see CMakeLists.txt.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "host.hpp"
+#include "cli/history.hpp"
+
+static CliHistory history;
+
+int main(int argc, char **argv) {
+    const int n = argc > 2 ? atoi(argv[2]) : 200000;
+    char line[64], buf[128];
+    CliHistory::cursor_t cur;
+    volatile size_t sink = 0;
+
+    for (int i = 0; i < 400; i++) {
+        snprintf(line, sizeof(line), "set motor%03d speed %05d accel 100 ramp on",
+            i % 97, i);
+        history.append(line, strlen(line));
+    }
+
+    double t0 = hostNow();
+    for (int i = 0; i < n; i++) {
+        history.rewind(cur);
+        for (int k = 0; k < 8; k++) {
+            history.seek_backward(cur);
+            sink += history.read(cur, buf, sizeof(buf));
+        }
+    }
+
+    double t1 = hostNow();
+    for (int i = 0; i < n; i++) {
+        history.rewind(cur);
+        history.read(cur, buf, sizeof(buf));
+        sink += history.append(buf, strlen(buf));
+    }
+
+    double t2 = hostNow();
+    for (int i = 0; i < n / 10; i++) {
+        snprintf(line, sizeof(line), "set motor%03d speed %05d accel 100 ramp on",
+            i % 97, i);
+        sink += history.append(line, strlen(line));
+    }
+
+    double t3 = hostNow();
+    printf("{\"bench\":\"history\",\"variant\":\"%s\",\"nav_read_ns\":%.1f,"
+        "\"dup_append_ns\":%.1f,\"append_ns\":%.1f}\n", argc > 1 ? argv[1] : "",
+        (t1 - t0) / n / 8 * 1e9, (t2 - t1) / n * 1e9, (t3 - t2) / (n / 10) * 1e9);
+    return 0;
+}
@@ -0,0 +1,76 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+/*
+ * Counts the bytes written while scrolling through a history of similar
+ * commands with Arrow Up and back with Arrow Down. On a slow serial link the
+ * bytes per key press matter more than the CPU time.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "host.hpp"
+#include "cli/cli.hpp"
+
+static TestStream io;
+Stream &Serial = io;
+
+CLI_COMMAND(set) {
+    return 0;
+}
+
+static void type(Cli &cli, const char *str) {
+    for (size_t len = strlen(str), i = 0; i < len; ) {
+        i += cli.read(&str[i], len - i);
+    }
+}
+
+int main(void) {
+    const char *lines[] = {
+        "set gain 10", "set gain 12", "set gain 14", "set gain 16",
+        "set offset 3", "set offset -3", "set gain 18", "set mode auto"
+    };
+    const size_t cnt = sizeof(lines) / sizeof(lines[0]);
+    Cli cli;
+    char line[32];
+
+    cli.begin(&io);
+    for (size_t i = 0; i < cnt; i++) {
+        snprintf(line, sizeof(line), "%s\r", lines[i]);
+        type(cli, line);
+    }
+
+    /* Scroll up through all lines and down again */
+    io.take();
+    for (size_t i = 0; i < cnt; i++) {
+        type(cli, "\033[A");
+    }
+    for (size_t i = 0; i < cnt; i++) {
+        type(cli, "\033[B");
+    }
+
+    printf("{\"bench\":\"recall\",\"keys\":%zu,\"bytes\":%zu}\n", 2 * cnt,
+        io.out.size());
+    return 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+/*
+ * Measures the setup of a command table of 128 commands: registered by
+ * constructors and sorted by Cli::begin(), or defined at compile time by
+ * CLI_COMMAND_TABLE() with CLI_CMDTAB_STATIC enabled.
+ */
+
+#include <stdio.h>
+#include "host.hpp"
+#include "cli/cli.hpp"
+
+class NullStream : public TestStream {
+    public:
+        size_t write(const uint8_t *, size_t len) override {
+            return len;
+        }
+};
+
+static NullStream io;
+Stream &Serial = io;
+static volatile int sink = 0;
+
+/**
+ * @brief Taken by the dynamic initialization before the commands below are
+ * registered, which is done in the order of definition.
+ */
+static const double tStart = hostNow();
+
+/*
+ * The command names are c00 to c7f, each row are 16 of them. The rows are
+ * defined in reverse order, so registered commands have to be sorted like
+ * commands spread over several files.
+ */
+#define BENCH_ROW(_p, _x)                                           \
+    _x(_p ## 0) _x(_p ## 1) _x(_p ## 2) _x(_p ## 3)                 \
+    _x(_p ## 4) _x(_p ## 5) _x(_p ## 6) _x(_p ## 7)                 \
+    _x(_p ## 8) _x(_p ## 9) _x(_p ## a) _x(_p ## b)                 \
+    _x(_p ## c) _x(_p ## d) _x(_p ## e) _x(_p ## f)
+
+#define BENCH_DEFINE(_name)                                         \
+    CLI_COMMAND(_name) {                                            \
+        sink += argc;                                               \
+        return 0;                                                   \
+    }
+
+#define BENCH_ENTRY(_name)          CLI_COMMAND_ENTRY(_name),
+
+BENCH_ROW(c7, BENCH_DEFINE)
+BENCH_ROW(c6, BENCH_DEFINE)
+BENCH_ROW(c5, BENCH_DEFINE)
+BENCH_ROW(c4, BENCH_DEFINE)
+BENCH_ROW(c3, BENCH_DEFINE)
+BENCH_ROW(c2, BENCH_DEFINE)
+BENCH_ROW(c1, BENCH_DEFINE)
+BENCH_ROW(c0, BENCH_DEFINE)
+
+#if CLI_CMDTAB_STATIC != 0
+CLI_COMMAND_TABLE(
+    BENCH_ROW(c0, BENCH_ENTRY) BENCH_ROW(c1, BENCH_ENTRY)
+    BENCH_ROW(c2, BENCH_ENTRY) BENCH_ROW(c3, BENCH_ENTRY)
+    BENCH_ROW(c4, BENCH_ENTRY) BENCH_ROW(c5, BENCH_ENTRY)
+    BENCH_ROW(c6, BENCH_ENTRY) BENCH_ROW(c7, BENCH_ENTRY)
+);
+
+/**
+ * @brief The table is a constant array, nothing of it is in RAM.
+ */
+static const size_t TableRam = 0;
+#else
+/**
+ * @brief The table and one registrar object per command.
+ */
+static const size_t TableRam = sizeof(cliCmd_t) * CLI_COMMANDS_MAX +
+    sizeof(CliCommand) * 128;
+#endif
+
+int main(int argc, char **argv) {
+    double t0 = hostNow();
+    Cli cli;
+
+    cli.begin(&io);
+
+    double t1 = hostNow();
+    CHECK(CliCommand::getCmdCnt() == 128);
+    CHECK(CliCommand::isSorted());
+    CHECK(CliCommand::exec(io, "c42", nullptr, 0) == 0);
+
+    printf("{\"bench\":\"table\",\"variant\":\"%s\",\"commands\":%u,"
+        "\"register_us\":%.2f,\"begin_us\":%.2f,\"table_ram\":%u}\n",
+        argc > 1 ? argv[1] : "", (unsigned) CliCommand::getCmdCnt(),
+        (t0 - tStart) * 1e6, (t1 - t0) * 1e6, (unsigned) TableRam);
+    return hostResult();
+}
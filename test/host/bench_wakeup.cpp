@@ -0,0 +1,91 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+/*
+ * Feeds one line every 10 ms through the receive ring and counts the loop()
+ * calls needed for 100 lines. A condition variable stands in for the sleep of
+ * the device. Run with "poll" to call loop() in a tight loop instead.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+#include "host.hpp"
+#include "cli/cli.hpp"
+
+static TestStream io;
+Stream &Serial = io;
+static std::atomic<unsigned long> calls(0);
+static std::mutex lock;
+static std::condition_variable event;
+static bool pending = false;
+
+CLI_COMMAND(ping) {
+    calls++;
+    return 0;
+}
+
+/* Stands in for giving a semaphore or setting an event flag */
+static void wakeup(void *) {
+    std::lock_guard<std::mutex> guard(lock);
+    pending = true;
+    event.notify_one();
+}
+
+int main(int argc, char **argv) {
+    const unsigned long lines = 100;
+    bool polling = argc > 1 && strcmp(argv[1], "poll") == 0;
+    unsigned long wakeups = 0;
+    Cli cli;
+
+    cli.begin(&io);
+    cli.setWakeup(wakeup);
+
+    /* One line every 10 ms, like an operator typing or a host polling */
+    std::thread producer([&cli]() {
+        for (unsigned long i = 0; i < lines; i++) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            cli.push("ping\r", 5);
+        }
+    });
+
+    while (calls < lines) {
+        if (!polling && !cli.hasPendingWork()) {
+            std::unique_lock<std::mutex> guard(lock);
+            event.wait(guard, [] { return pending; });
+            pending = false;
+        }
+
+        cli.loop();
+        wakeups++;
+    }
+
+    producer.join();
+    printf("{\"bench\":\"wakeup\",\"variant\":\"%s\",\"lines\":%lu,"
+        "\"loop_calls\":%lu}\n", polling ? "poll" : "event", lines, wakeups);
+    return 0;
+}
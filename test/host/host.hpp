@@ -0,0 +1,163 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+/*
+ * Helpers shared by the host tests and benchmarks, see doc/HOST_BUILD.md.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <stdio.h>
+#include <string>
+#include <Arduino.h>
+
+/**
+ * @brief Used to check a condition in a test. A failure is printed and
+ * counted, the test goes on. See hostResult().
+ */
+#define CHECK(_cond)                                                        \
+    do {                                                                    \
+        if (!(_cond)) {                                                     \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__,          \
+                __LINE__, #_cond);                                          \
+            hostFailures++;                                                 \
+        }                                                                   \
+    } while (0)
+
+/**
+ * @brief Number of failed checks of the test.
+ */
+static int hostFailures = 0;
+
+/**
+ * @brief Used to get the exit code of a test.
+ */
+static inline int hostResult(void) {
+    if (hostFailures > 0) {
+        fprintf(stderr, "%d check(s) failed\n", hostFailures);
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Used to get a monotonic time in seconds for benchmarks.
+ */
+static inline double hostNow(void) {
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief A stream fed from memory which records all output.
+ */
+class TestStream : public Stream {
+    public:
+        /**
+         * @brief The input, read() consumes it from inPos on.
+         */
+        std::string in;
+
+        size_t inPos = 0;
+
+        /**
+         * @brief All output written so far.
+         */
+        std::string out;
+
+        /**
+         * @brief The number of calls to write().
+         */
+        size_t writes = 0;
+
+        /**
+         * @brief The number of bytes reported by availableForWrite(), reduced
+         * by every write. Negative for a stream which never stalls. A write
+         * of more bytes counts as blocking, see blocked.
+         */
+        int writable = -1;
+
+        /**
+         * @brief The number of writes which would have blocked.
+         */
+        size_t blocked = 0;
+
+        using Print::write;
+
+        int available() override {
+            return (int) (in.size() - inPos);
+        }
+
+        int read() override {
+            return inPos < in.size() ? (uint8_t) in[inPos++] : -1;
+        }
+
+        int peek() override {
+            return inPos < in.size() ? (uint8_t) in[inPos] : -1;
+        }
+
+        size_t write(uint8_t byte) override {
+            return write(&byte, 1);
+        }
+
+        size_t write(const uint8_t *buf, size_t len) override {
+            if (writable >= 0) {
+                if (len > (size_t) writable) {
+                    blocked++;
+                    writable = 0;
+                } else {
+                    writable -= (int) len;
+                }
+            }
+
+            out.append((const char *) buf, len);
+            writes++;
+            return len;
+        }
+
+        int availableForWrite() override {
+            return writable < 0 ? 4096 : writable;
+        }
+
+        /**
+         * @brief Used to append input, consumed input is discarded.
+         */
+        void feed(const std::string &data) {
+            in.erase(0, inPos);
+            inPos = 0;
+            in += data;
+        }
+
+        /**
+         * @brief Used to get and clear the output written so far.
+         */
+        std::string take(void) {
+            std::string ret;
+
+            ret.swap(out);
+            return ret;
+        }
+};
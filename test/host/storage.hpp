@@ -0,0 +1,116 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+/*
+ * A journal storage in host memory for the tests, see CliJournal.
+ */
+
+#pragma once
+
+#include <string.h>
+#include <vector>
+#include "cli/journal.hpp"
+
+/**
+ * @brief A CliJournalStorage in memory which behaves like flash: erased bytes
+ * read as 0xFF and a write to a byte which has not been erased is counted.
+ * A reset while writing is simulated by a budget of bytes which are still
+ * written, the storage fails afterwards until it is powered up again.
+ */
+class MemStorage : public CliJournalStorage {
+
+    public:
+
+        MemStorage(size_t siz) : Data(siz, 0xFF) {}
+
+        /**
+         * @brief The number of bytes written without being erased before.
+         */
+        size_t rewrites = 0;
+
+        /**
+         * @brief The number of bytes which are still written before the
+         * simulated reset, negative for no reset.
+         */
+        long budget = -1;
+
+        size_t size(void) override {
+            return Data.size();
+        }
+
+        bool read(size_t addr, void *data, size_t len) override {
+            if (budget == 0 || addr + len > Data.size()) {
+                return false;
+            }
+
+            memcpy(data, &Data[addr], len);
+            return true;
+        }
+
+        bool write(size_t addr, const void *data, size_t len) override {
+            const uint8_t *pData = (const uint8_t *) data;
+
+            if (addr + len > Data.size()) {
+                return false;
+            }
+
+            for (size_t i = 0; i < len; i++) {
+                if (budget == 0) {
+                    return false;
+                }
+                if (budget > 0) {
+                    budget--;
+                }
+                if (Data[addr + i] != 0xFF) {
+                    rewrites++;
+                }
+                Data[addr + i] = pData[i];
+            }
+
+            return true;
+        }
+
+        bool erase(void) override {
+            if (budget == 0) {
+                return false;
+            }
+
+            memset(Data.data(), 0xFF, Data.size());
+            return true;
+        }
+
+        /**
+         * @brief Used to end a simulated reset, the content is kept.
+         */
+        void powerUp(void) {
+            budget = -1;
+        }
+
+    private:
+
+        /**
+         * @brief The content of the storage.
+         */
+        std::vector<uint8_t> Data;
+};
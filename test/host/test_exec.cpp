@@ -0,0 +1,153 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+/*
+ * Checks Cli::execLine(), also when called from within a command.
+ */
+
+#include <string.h>
+#include <string>
+#include "host.hpp"
+#include "cli/cli.hpp"
+
+static TestStream io;
+Stream &Serial = io;
+static Cli cli;
+static std::string seen;
+
+CLI_COMMAND(inner) {
+    for (uint8_t i = 0; i < argc; i++) {
+        seen += argv[i];
+    }
+    return 0;
+}
+
+CLI_COMMAND(outer) {
+    int8_t ret = 0;
+
+    /* The nested line has more arguments than this one, all of them would
+     * have overwritten argv if it was shared */
+    ret = cli.execLine("inner w x y z", 13);
+    seen += "|";
+    for (uint8_t i = 0; i < argc; i++) {
+        seen += argv[i];
+    }
+    return ret;
+}
+
+CLI_COMMAND_TYPED(speed, 1, CLI_ARG_UINT("rpm")) {
+    seen += "speed";
+    return 0;
+}
+
+CLI_COMMAND(fail) {
+    return argc > 0 ? INT8_MIN + 1 : INT8_MIN;
+}
+
+CLI_COMMAND(retry) {
+    /* Rejected arguments of the nested line are not the ones of this
+     * command, so its own failure is reported */
+    cli.execLine("speed fast", 10);
+    return 3;
+}
+
+/**
+ * @brief A command executing a further line keeps its own arguments.
+ */
+static void testNested(void) {
+    seen.clear();
+    CHECK(cli.execLine("outer a b", 9) == 0);
+    CHECK(seen == "wxyz|ab");
+
+    /* The same from typed input, where the arguments point into the input
+     * buffer of the session */
+    seen.clear();
+    io.feed("outer c d\r");
+    cli.loop();
+    CHECK(seen == "wxyz|cd");
+}
+
+/**
+ * @brief Like typed input, a line of only spaces and tabs is ignored.
+ */
+static void testBlank(void) {
+    io.take();
+    CHECK(cli.execLine("", 0) == 0);
+    CHECK(cli.execLine("\r\n", 2) == 0);
+    CHECK(cli.execLine("   ", 3) == 0);
+    CHECK(cli.execLine(" \t \t\r\n", 6) == 0);
+    CHECK(io.take().empty());
+
+    /* Whitespace around a command is still up to the parser */
+    seen.clear();
+    CHECK(cli.execLine("inner a ", 8) == 0);
+    CHECK(seen == "a");
+}
+
+/**
+ * @brief Invalid arguments of a typed command are explained once, a command
+ * returning INT8_MIN or INT8_MIN + 1 on its own is reported like any other
+ * failure.
+ */
+static void testFailures(void) {
+    std::string out;
+
+    io.take();
+    seen.clear();
+    CHECK(cli.execLine("speed fast", 10) == INT8_MIN);
+    out = io.take();
+    CHECK(seen.empty());
+    CHECK(out.find("Error, invalid argument rpm: fast") != std::string::npos);
+    CHECK(out.find("cmd fails") == std::string::npos);
+
+    /* A negative value is rejected, also behind white space in quotes.
+     * strtoul() with a 64 bit long negates the second one to 1. */
+    CHECK(cli.execLine("speed -1", 8) == INT8_MIN);
+    CHECK(cli.execLine("speed \" -1\"", 12) == INT8_MIN);
+    CHECK(cli.execLine("speed \" -18446744073709551615\"", 30) == INT8_MIN);
+    CHECK(seen.empty());
+    io.take();
+
+    CHECK(cli.execLine("speed 100", 9) == 0);
+    CHECK(seen == "speed");
+
+    CHECK(cli.execLine("fail", 4) == INT8_MIN);
+    CHECK(io.take() == "Error, cmd fails: -128\n");
+    CHECK(cli.execLine("fail 1", 6) == INT8_MIN + 1);
+    CHECK(io.take() == "Error, cmd fails: -127\n");
+
+    CHECK(cli.execLine("retry", 5) == 3);
+    out = io.take();
+    CHECK(out.find("Error, invalid argument rpm: fast") != std::string::npos);
+    CHECK(out.find("Error, cmd fails: 3\n") != std::string::npos);
+}
+
+int main(void) {
+    cli.begin(&io);
+    testNested();
+    testBlank();
+    testFailures();
+
+    return hostResult();
+}
@@ -0,0 +1,136 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+/*
+ * Checks groups of subcommands, built with a registered and with a static
+ * command table, with and without task commands.
+ */
+
+#include <string>
+#include "host.hpp"
+#include "cli/cli.hpp"
+
+static TestStream io;
+Stream &Serial = io;
+static Cli cli;
+static std::string seen;
+
+static int8_t record(const char *name, const char *argv[], uint8_t argc) {
+    seen = name;
+    for (uint8_t i = 0; i < argc; i++) {
+        seen += ":";
+        seen += argv[i];
+    }
+    return 0;
+}
+
+CLI_SUBCOMMAND(net_ip, show) {
+    return record("show", argv, argc);
+}
+
+CLI_SUBGROUP(net_ip,
+    CLI_SUBALIAS_ENTRY(net_ip, ls, show),
+    CLI_SUBCOMMAND_ENTRY(net_ip, show)
+);
+
+CLI_SUBCOMMAND(net, status) {
+    return record("status", argv, argc);
+}
+
+CLI_COMMAND_GROUP(net,
+    CLI_SUBGROUP_ENTRY(net, ip),
+    CLI_SUBCOMMAND_ENTRY(net, status)
+);
+
+CLI_COMMAND(echo) {
+    return record("echo", argv, argc);
+}
+
+#if CLI_CMD_TASKS != 0
+CLI_COMMAND_TASK(wait) {
+    if (ctx.call < 2) {
+        return CLI_CMD_BUSY;
+    }
+    return record("wait", argv, argc);
+}
+#endif
+
+#if CLI_CMDTAB_STATIC != 0
+CLI_COMMAND_TABLE(
+    CLI_ALIAS_ENTRY(e, echo),
+    CLI_COMMAND_ENTRY(echo),
+    CLI_COMMAND_GROUP_ENTRY(net)
+#if CLI_CMD_TASKS != 0
+    , CLI_COMMAND_TASK_ENTRY(wait)
+#endif
+);
+#else
+CLI_ALIAS(e, echo);
+#endif
+
+/**
+ * @brief Every kind of entry reaches its function, entries without
+ * subcommands are not mistaken for a group.
+ */
+static void testEntries(void) {
+    seen.clear();
+    CHECK(cli.execLine("net ip show a", 13) == 0);
+    CHECK(seen == "show:a");
+
+    seen.clear();
+    CHECK(cli.execLine("net ip ls", 9) == 0);
+    CHECK(seen == "show");
+
+    seen.clear();
+    CHECK(cli.execLine("net status b c", 14) == 0);
+    CHECK(seen == "status:b:c");
+
+    seen.clear();
+    CHECK(cli.execLine("echo net ip", 11) == 0);
+    CHECK(seen == "echo:net:ip");
+
+    seen.clear();
+    CHECK(cli.execLine("e d", 3) == 0);
+    CHECK(seen == "echo:d");
+
+#if CLI_CMD_TASKS != 0
+    seen.clear();
+    CHECK(cli.execLine("wait f", 6) == 0);
+    CHECK(seen == "wait:f");
+#endif
+
+    /* The group explains a missing subcommand on its own */
+    seen.clear();
+    io.take();
+    CHECK(cli.execLine("net ip", 6) == INT8_MIN);
+    CHECK(seen.empty());
+    CHECK(io.take() == "Error, missing subcommand\nSubcommands: ls show\n");
+}
+
+int main(void) {
+    cli.begin(&io);
+    testEntries();
+
+    return hostResult();
+}
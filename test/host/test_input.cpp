@@ -0,0 +1,289 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+/*
+ * Checks the processing of interactive input by Cli::loop() and Cli::read().
+ */
+
+#include <string.h>
+#include <string>
+#include "host.hpp"
+#include "cli/cli.hpp"
+
+static TestStream io;
+Stream &Serial = io;
+static int calls = 0;
+static std::string said;
+
+CLI_COMMAND(ping) {
+    calls++;
+    return 0;
+}
+
+CLI_COMMAND(led_on) {
+    return 0;
+}
+
+CLI_COMMAND(led_off) {
+    return 0;
+}
+
+CLI_COMMAND(say) {
+    said.clear();
+    for (uint8_t i = 0; i < argc; i++) {
+        said += (i > 0) ? " " : "";
+        said += argv[i];
+    }
+    return 0;
+}
+
+/**
+ * @brief loop() drains all available input in chunks, but executes at most
+ * one command per call.
+ */
+static void testLoop(Cli &cli) {
+    std::string line(3 * CLI_RXCHUNKSIZ + 1, 'x');
+
+    io.take();
+    io.feed(line);
+    cli.loop();
+    CHECK(io.available() == 0);
+    CHECK(io.take() == line);
+
+    calls = 0;
+    io.feed("\x0bping\rping\r");
+    cli.loop();
+    CHECK(calls == 1);
+    CHECK(io.available() > 0 || cli.hasPendingWork());
+    cli.loop();
+    CHECK(calls == 2);
+    CHECK(!cli.hasPendingWork());
+}
+
+/**
+ * @brief Used to type the given keys and to get the output written for them.
+ */
+static std::string type(Cli &cli, const char *keys) {
+    io.take();
+    io.feed(keys);
+    while (io.available() > 0 || cli.hasPendingWork()) {
+        cli.loop();
+    }
+
+    return io.take();
+}
+
+/**
+ * @brief Each edit redraws only the part of the line behind the cursor and
+ * moves the cursor back by backspaces or by a CUB sequence.
+ */
+static void testEdit(Cli &cli) {
+    type(cli, "\x0bsay ac");
+
+    /* Insert and delete in the middle of the line */
+    CHECK(type(cli, "\033[D") == "\b");
+    CHECK(type(cli, "b") == "bc\b");
+    CHECK(type(cli, "\x7f") == "\bc\033[0K\b");
+    CHECK(type(cli, "B") == "Bc\b");
+    said.clear();
+    CHECK(type(cli, "\r") == "\n#>");
+    CHECK(said == "aBc");
+
+    /* Home, Right, Delete and End */
+    type(cli, "say xyz");
+    CHECK(type(cli, "\033[H") == "\033[7D");
+    CHECK(type(cli, "\033[C\033[C\033[C\033[C") == "say ");
+    CHECK(type(cli, "\033[3~") == "yz\033[0K\b\b");
+    CHECK(type(cli, "\033[F") == "yz");
+    type(cli, "\r");
+    CHECK(said == "yz");
+
+    /* ctrl-W deletes the word before the cursor, then the space and the
+     * word before it */
+    type(cli, "say one two");
+    CHECK(type(cli, "\x17") == "\b\b\b\033[0K");
+    CHECK(type(cli, "\x17") == "\b\b\b\b\033[0K");
+    type(cli, "three\r");
+    CHECK(said == "three");
+
+    /* The count of a CSI sequence is consumed, arrow keys move by one */
+    type(cli, "say abc");
+    CHECK(type(cli, "\033[15D") == "\b");
+    CHECK(type(cli, "X") == "Xc\b");
+    type(cli, "\r");
+    CHECK(said == "abXc");
+
+    /* Home and End sent as SS3 sequences, far moves as CUB and CUF */
+    type(cli, "say ab");
+    CHECK(type(cli, "\033OH") == "\033[6D");
+    CHECK(type(cli, "\033OF") == "\033[6C");
+    type(cli, "c\r");
+    CHECK(said == "abc");
+}
+
+#if CLI_TAB_COMPLETION != 0 && CLI_TAB_CYCLE == 0
+/**
+ * @brief The first Tab completes the common prefix and lists the matches,
+ * a second one lists them again.
+ */
+static void testTab(Cli &cli) {
+    std::string out;
+
+    io.feed("\x0ble\t");
+    cli.loop();
+    out = io.take();
+    CHECK(out.find("led_") != std::string::npos);
+    CHECK(out.find("led_off") != std::string::npos);
+
+    io.feed("\t");
+    cli.loop();
+    out = io.take();
+    CHECK(out.find("led_off") != std::string::npos);
+    CHECK(out.find("led_on") != std::string::npos);
+    CHECK(out.find("#>led_") != std::string::npos);
+
+    io.feed("\x0b");
+    cli.loop();
+    io.take();
+}
+#endif
+
+#if CLI_TAB_COMPLETION != 0 && CLI_TAB_CYCLE != 0
+/**
+ * @brief The first Tab completes the common prefix and lists the matches,
+ * further ones replace the completed part by the next match and finally by
+ * the common prefix again.
+ */
+static void testTabCycle(Cli &cli) {
+    while (cli.hasPendingWork()) {
+        cli.loop();
+    }
+    io.take();
+
+    io.feed("\x0ble\t");
+    cli.loop();
+    CHECK(io.take() == "\r\033[2K#>led_o\nled_off   led_on\n#>led_o");
+
+    /* Only the differing part of the line is rewritten */
+    io.feed("\t");
+    cli.loop();
+    CHECK(io.take() == "ff");
+
+    io.feed("\t");
+    cli.loop();
+    CHECK(io.take() == "\b\b\033[0Kn");
+
+    io.feed("\t");
+    cli.loop();
+    CHECK(io.take() == "\b\033[0K");
+
+    io.feed("\t\r");
+    while (cli.hasPendingWork()) {
+        cli.loop();
+    }
+    CHECK(io.take() == "ff\n#>");
+}
+#endif
+
+#if CLI_HISTORYSIZ > 0 && CLI_HISTORY_SEARCH > 0
+/**
+ * @brief Backspace in the reverse history search keeps a failed search
+ * failed, as long as the shorter pattern does not match either.
+ */
+static void testSearch(Cli &cli) {
+    std::string out;
+
+    io.feed("\x0bping 1\r\x12pxy");
+    while (cli.hasPendingWork()) {
+        cli.loop();
+    }
+    io.take();
+
+    io.feed("\x7f");
+    cli.loop();
+    out = io.take();
+    CHECK(out.find("(failed reverse-i-search)`px'") != std::string::npos);
+
+    io.feed("\x7f");
+    cli.loop();
+    out = io.take();
+    CHECK(out.find("(reverse-i-search)`p': ping 1") != std::string::npos);
+    CHECK(out.find("failed") == std::string::npos);
+
+    /* ctrl-G cancels the search */
+    io.feed("\x07\x0b");
+    cli.loop();
+    io.take();
+}
+#endif
+
+/**
+ * @brief Recalling a line from the history writes nothing without echo.
+ */
+static void testRecallNoEcho(Cli &cli) {
+    io.feed("\x0bping 2\r");
+    while (cli.hasPendingWork()) {
+        cli.loop();
+    }
+    io.take();
+
+    cli.setEcho(false);
+    io.feed("\033[A");
+    cli.loop();
+    CHECK(io.take().empty());
+
+    io.feed("\033[B");
+    cli.loop();
+    CHECK(io.take().empty());
+
+    calls = 0;
+    io.feed("\033[A\r");
+    while (cli.hasPendingWork()) {
+        cli.loop();
+    }
+    CHECK(calls == 1);
+    cli.setEcho(true);
+}
+
+int main(void) {
+    Cli cli;
+
+    cli.begin(&io);
+    testLoop(cli);
+    testEdit(cli);
+#if CLI_TAB_COMPLETION != 0 && CLI_TAB_CYCLE == 0
+    testTab(cli);
+#endif
+#if CLI_TAB_COMPLETION != 0 && CLI_TAB_CYCLE != 0
+    testTabCycle(cli);
+#endif
+#if CLI_HISTORYSIZ > 0 && CLI_HISTORY_SEARCH > 0
+    testSearch(cli);
+#endif
+#if CLI_HISTORYSIZ > 0
+    testRecallNoEcho(cli);
+#endif
+
+    return hostResult();
+}
@@ -0,0 +1,194 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+/*
+ * Checks the persistent command history by CliJournal on a storage in
+ * memory, see storage.hpp.
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "host.hpp"
+#include "storage.hpp"
+#include "cli/cli.hpp"
+
+static TestStream io;
+Stream &Serial = io;
+
+typedef std::vector<std::string> lines_t;
+
+/**
+ * @brief Used to get the lines of a history, the oldest one first.
+ */
+static lines_t lines(CliHistory &history) {
+    CliHistory::cursor_t cur;
+    char line[CLI_COMMANDSIZ];
+    lines_t ret;
+
+    history.rewind(cur);
+    for (size_t n = 0; history.seek(cur, n); n++) {
+        size_t len = history.read(cur, line, sizeof(line));
+
+        ret.insert(ret.begin(), std::string(line, len));
+    }
+
+    return ret;
+}
+
+static void append(CliHistory &history, const char *line) {
+    history.append(line, strlen(line));
+}
+
+/**
+ * @brief Used to append numbered lines, each of them is a record of 8 bytes.
+ */
+static void appendNumbered(CliHistory &history, int first, int last) {
+    char line[8];
+
+    for (int i = first; i <= last; i++) {
+        snprintf(line, sizeof(line), "cmd %02d", i);
+        append(history, line);
+    }
+}
+
+/**
+ * @brief Used to restore a new history from the storage, like after a reset.
+ */
+static lines_t reboot(MemStorage &storage, size_t *pCnt) {
+    CliHistory history;
+    CliJournal journal(storage);
+
+    *pCnt = journal.restore(history);
+    return lines(history);
+}
+
+/**
+ * @brief The lines appended to the history are restored in the same order.
+ */
+static void testRestore(void) {
+    MemStorage storage(256);
+    CliHistory history;
+    CliJournal journal(storage);
+    size_t cnt = 0;
+
+    CHECK(journal.restore(history) == 0);
+    history.set_journal(&journal);
+    append(history, "ping 1");
+    append(history, "led on");
+    append(history, "status");
+
+    CHECK(reboot(storage, &cnt) == lines_t({"ping 1", "led on", "status"}));
+    CHECK(cnt == 3);
+    CHECK(journal.getStats().appends == 3);
+    CHECK(journal.getStats().erases == 1);
+    CHECK(storage.rewrites == 0);
+}
+
+/**
+ * @brief A record torn by a reset is dropped, the next line compacts the
+ * journal instead of writing behind it.
+ */
+static void testTruncated(void) {
+    MemStorage storage(256);
+    CliHistory history;
+    CliJournal journal(storage);
+    size_t cnt = 0;
+
+    journal.restore(history);
+    history.set_journal(&journal);
+    append(history, "ping 1");
+    append(history, "led on");
+
+    /* The record header and two bytes of the line */
+    storage.budget = 4;
+    append(history, "status 1");
+    storage.powerUp();
+    CHECK(reboot(storage, &cnt) == lines_t({"ping 1", "led on"}));
+    CHECK(cnt == 2);
+
+    CliHistory restored;
+    CliJournal next(storage);
+
+    next.restore(restored);
+    restored.set_journal(&next);
+    append(restored, "status 2");
+    CHECK(next.getStats().compactions == 1);
+    CHECK(reboot(storage, &cnt) == lines_t({"ping 1", "led on", "status 2"}));
+    CHECK(storage.rewrites == 0);
+}
+
+/**
+ * @brief A full storage is compacted to the most recent lines which fit.
+ */
+static void testCompaction(void) {
+    /* The journal header and seven records */
+    MemStorage storage(64);
+    CliHistory history;
+    CliJournal journal(storage);
+    size_t cnt = 0;
+
+    journal.restore(history);
+    history.set_journal(&journal);
+    appendNumbered(history, 1, 10);
+
+    CHECK(journal.getStats().compactions == 3);
+    CHECK(journal.getStats().erases == 4);
+    CHECK(reboot(storage, &cnt) == lines_t({"cmd 04", "cmd 05", "cmd 06",
+        "cmd 07", "cmd 08", "cmd 09", "cmd 10"}));
+    CHECK(cnt == 7);
+    CHECK(storage.rewrites == 0);
+}
+
+/**
+ * @brief A reset during a compaction loses the lines which have not been
+ * rewritten yet, the ones written so far are restored.
+ */
+static void testCompactionReset(void) {
+    MemStorage storage(64);
+    CliHistory history;
+    CliJournal journal(storage);
+    size_t cnt = 0;
+
+    journal.restore(history);
+    history.set_journal(&journal);
+    appendNumbered(history, 1, 7);
+
+    /* The journal header and two records */
+    storage.budget = 8 + 2 * 8;
+    appendNumbered(history, 8, 8);
+    storage.powerUp();
+    CHECK(reboot(storage, &cnt) == lines_t({"cmd 02", "cmd 03"}));
+    CHECK(cnt == 2);
+}
+
+int main(void) {
+    testRestore();
+    testTruncated();
+    testCompaction();
+    testCompactionReset();
+
+    return hostResult();
+}
@@ -0,0 +1,206 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+/*
+ * Checks CLI_TX_NONBLOCK with a stream which takes only as many bytes as
+ * availableForWrite() reports. Editing input must never issue a write which
+ * would block, and queued output must arrive complete and in order once the
+ * stream takes it again. Response frames must never be cut short.
+ */
+
+#include <chrono>
+#include <string.h>
+#include <string>
+#include <thread>
+#include "host.hpp"
+#include "cli/cli.hpp"
+
+static TestStream io;
+Stream &Serial = io;
+
+CLI_COMMAND(echo) {
+    for (uint8_t i = 0; i < argc; i++) {
+        ioStream.printf("%s ", argv[i]);
+    }
+    ioStream.printf("\n");
+    return 0;
+}
+
+CLI_COMMAND(led_on) {
+    return 0;
+}
+
+CLI_COMMAND(led_off) {
+    return 0;
+}
+
+/**
+ * @brief Used to type the input and to call loop() until all output has been
+ * written, with the stream taking at most the given number of bytes per call.
+ */
+static std::string run(Cli &cli, TestStream &stream, const std::string &input,
+                       int perLoop) {
+    stream.take();
+    stream.feed(input);
+
+    do {
+        stream.writable = perLoop;
+        cli.loop();
+    } while (cli.hasPendingWork());
+
+    return stream.take();
+}
+
+/**
+ * @brief Used to build a request frame, see CLI_FRAMED.
+ */
+static std::string request(uint8_t seq, const std::string &line) {
+    std::string frame = "\x10\x02";
+    uint16_t crc = 0xFFFF;
+
+    frame += (char) seq;
+    frame += (char) line.size();
+    frame += line;
+
+    for (size_t i = 2; i < frame.size(); i++) {
+        crc ^= (uint16_t) ((uint8_t) frame[i]) << 8;
+        for (int k = 0; k < 8; k++) {
+            crc = (crc & 0x8000) ? (uint16_t) ((crc << 1) ^ 0x1021) :
+                                   (uint16_t) (crc << 1);
+        }
+    }
+
+    frame += (char) (crc >> 8);
+    frame += (char) (crc & 0xFF);
+    return frame;
+}
+
+/**
+ * @brief A response frame longer than the queue arrives completely, even if
+ * the stream is stalled.
+ */
+static void testFrame(Cli &cli) {
+    std::string args = "aaaaaaaaaaaaaaaa bbbbbbbbbbbbbbbb cccccccccccccccc "
+                       "dddddddddddddddd";
+    std::string out;
+    size_t len = 0;
+
+    io.take();
+    io.feed(request(7, "echo " + args));
+    do {
+        io.writable = 0;
+        cli.loop();
+    } while (io.available() > 0);
+
+    out = io.take();
+    CHECK(out.size() >= 7);
+    if (out.size() >= 7) {
+        len = ((uint8_t) out[5] << 8) | (uint8_t) out[6];
+        CHECK(out.compare(0, 2, "\x10\x02") == 0);
+        CHECK(out[2] == 7);
+        CHECK(out[3] == 0);
+        CHECK(len == args.size() + 2);
+        CHECK(out.size() == 7 + len + 2);
+        CHECK(len > CLI_TXBUFSIZ);
+    }
+}
+
+/**
+ * @brief A partial request frame is dropped by a new DLE STX or by a pause
+ * longer than CLI_FRAME_TIMEOUT, so the next request is answered. A DLE not
+ * followed by STX is ordinary input.
+ */
+static void testResync(Cli &cli) {
+    std::string first = request(1, "echo abc").substr(0, 6);
+    std::string out;
+
+    out = run(cli, io, "\x10" "a\x0b", -1);
+    CHECK(out == "\x10" "a\r\033[2K#>");
+
+    out = run(cli, io, first + request(2, "echo x"), -1);
+    CHECK(out.compare(0, 10, std::string("\x10\x02\x02\x00\x00\x00\x03x \n",
+        10)) == 0);
+    CHECK(out.size() == 12);
+
+    run(cli, io, first, -1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(
+        2 * CLI_FRAME_TIMEOUT));
+    out = run(cli, io, request(3, "echo y"), -1);
+    CHECK(out.compare(0, 10, std::string("\x10\x02\x03\x00\x00\x00\x03y \n",
+        10)) == 0);
+    CHECK(out.size() == 12);
+}
+
+int main(void) {
+    /* Editing input which does not execute a command, so every write is
+     * issued by the library */
+    const std::string edit = "ec\t a b\x7f\x7f\x1b[D\x1b[C le\t\t\x7f\x7f\x7f\x0b";
+    TestStream free;
+    Cli reference;
+    Cli cli;
+    cliTxStats_t stats;
+
+    reference.begin(&free);
+    cli.begin(&io);
+    run(reference, free, "echo 1\r", -1);
+    run(cli, io, "echo 1\r", -1);
+
+    /* A stream which is stalled completely: nothing may block, the output is
+     * queued or dropped */
+    io.take();
+    io.blocked = 0;
+    io.writable = 0;
+    for (int i = 0; i < 20; i++) {
+        io.feed(edit);
+        while (io.available() > 0) {
+            io.writable = 0;
+            cli.loop();
+        }
+    }
+    stats = cli.getTxStats();
+    CHECK(io.blocked == 0);
+    CHECK(io.out.empty());
+    CHECK(stats.dropped > 0);
+    CHECK(stats.stalls > 0);
+
+    /* Trickling out the queue a few bytes per loop() call */
+    for (int i = 0; i < 1000 && cli.hasPendingWork(); i++) {
+        io.writable = 5;
+        cli.loop();
+    }
+    CHECK(io.blocked == 0);
+    CHECK(!cli.hasPendingWork());
+    CHECK(io.out.size() <= CLI_TXBUFSIZ);
+
+    /* As long as the queue does not overflow, a slow stream gets the same
+     * output as a fast one */
+    CHECK(run(cli, io, edit, 3) == run(reference, free, edit, -1));
+    CHECK(io.blocked == 0);
+    CHECK(run(cli, io, "echo a b\r", 3) == run(reference, free, "echo a b\r", -1));
+
+    testFrame(cli);
+    testResync(cli);
+
+    return hostResult();
+}
@@ -0,0 +1,155 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+/*
+ * Checks the single pass argument parser against the previous one, which
+ * shifted the buffer for every removed escape character. Both have to split
+ * a hand written corpus and a large number of random lines into the same
+ * arguments and have to reject the same lines.
+ */
+
+#include <random>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "host.hpp"
+#include "cli/cli.hpp"
+
+static TestStream io;
+Stream &Serial = io;
+static std::vector<std::string> args;
+static bool called = false;
+
+CLI_COMMAND(rec) {
+    called = true;
+    args.assign(argv, argv + argc);
+    return 0;
+}
+
+/**
+ * @brief The parser of libCli up to 4.7.0, the reference for the new one.
+ */
+static bool parseReference(char *buf, uint8_t i, std::vector<std::string> &argv) {
+    char *pArgv[CLI_ARGVSIZ];
+    uint8_t argc = 0;
+    uint8_t j = 0;
+    bool string = false;
+
+    while (buf[i] != 0) {
+        if (buf[i] == '\\' && buf[i + 1] != 0 && string) {
+            j = i;
+            while (buf[j] != 0) {
+                buf[j] = buf[j + 1];
+                j++;
+            }
+        } else if (buf[i] == '"') {
+            if (string) {
+                string = false;
+                buf[i] = 0;
+            }
+        } else if ((buf[i] == ' ') && (string == false)) {
+            while (buf[i] == ' ') {
+                buf[i++] = 0;
+            }
+
+            if (buf[i] == 0) {
+                break;
+            }
+
+            if (argc == CLI_ARGVSIZ) {
+                return false;
+            }
+
+            if (buf[i] == '"') {
+                string = true;
+                buf[i++] = 0;
+            }
+
+            pArgv[argc++] = &buf[i];
+        }
+
+        i++;
+    }
+
+    if (string) {
+        return false;
+    }
+
+    argv.assign(pArgv, pArgv + argc);
+    return true;
+}
+
+static void check(Cli &cli, const std::string &line) {
+    /* The reference reads one byte beyond the terminator for a quote at the
+     * end of the line, which has to be zero */
+    char buf[CLI_COMMANDSIZ + 1] = {0};
+    std::vector<std::string> expected;
+    bool valid = false;
+    int8_t ret = 0;
+
+    snprintf(buf, sizeof(buf) - 1, "rec%s", line.c_str());
+    valid = parseReference(buf, 3, expected);
+
+    called = false;
+    args.clear();
+    ret = cli.execLine(("rec" + line).c_str(), line.size() + 3);
+
+    CHECK((ret == 0) == valid);
+    if (called != valid || args != expected) {
+        fprintf(stderr, "different arguments for: rec%s\n", line.c_str());
+        hostFailures++;
+    }
+}
+
+int main(void) {
+    const char *corpus[] = {
+        "", " ", "   ", " a", " a b c", "  a   b  ", " a b c d", " a b c d e",
+        " \"a b\"", " \"a b\" c", " \"\"", " \"\" x", " \"a\\\"b\"", " \"a\\\\b\"",
+        " \"a\\b\"", " \"a\\", " \"a", " a\"b", " a\\b", " \"a\"b", " \"a\" \"b\"",
+        " \"\\\"\"", " x \"y z\" \"q\\\\\" w", " \"a b c d e f\"", " \"\\",
+        " a \"", " \"a\"\"b\"", " \"a\\\"\" b",
+    };
+    const char alphabet[] = "ab \"\\";
+    std::mt19937 rng(4711);
+    std::string line;
+    Cli cli;
+
+    cli.begin(&io);
+
+    for (const char *entry : corpus) {
+        check(cli, entry);
+    }
+
+    for (int i = 0; i < 100000; i++) {
+        size_t len = rng() % 40;
+
+        line = " ";
+        for (size_t k = 0; k < len; k++) {
+            line += alphabet[rng() % (sizeof(alphabet) - 1)];
+        }
+        check(cli, line);
+    }
+
+    return hostResult();
+}
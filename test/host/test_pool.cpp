@@ -0,0 +1,96 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+/*
+ * Checks that a session given back to a CliPool starts clean for the next
+ * client.
+ */
+
+#include <string>
+#include "host.hpp"
+#include "cli/cli.hpp"
+#include "cli/pool.hpp"
+
+static TestStream serial;
+Stream &Serial = serial;
+static CliPool<1> pool;
+static int calls = 0;
+
+/* CLI_COMMANDS_MAX is 1, so the second command overflows the table */
+CLI_COMMAND(ping) {
+    calls++;
+    return 0;
+}
+
+CLI_COMMAND(pong) {
+    calls++;
+    return 0;
+}
+
+static void drain(Cli *pCli, TestStream &io) {
+    while (io.available() > 0 || pCli->hasPendingWork()) {
+        pCli->loop();
+    }
+}
+
+/**
+ * @brief The overflow warning of begin() is printed for the first client
+ * only, nothing of the previous client is left for the next one.
+ */
+static void testReuse(void) {
+    TestStream first;
+    TestStream second;
+    Cli *pCli = pool.open(&first);
+
+    CHECK(pCli != nullptr);
+    CHECK(first.take().find("WARNING") != std::string::npos);
+    CHECK(pool.open(&second) == nullptr);
+
+    first.feed("ping\r");
+    drain(pCli, first);
+    CHECK(calls == 1);
+    pCli->setEcho(false);
+    first.feed("half");
+    drain(pCli, first);
+    pool.close(pCli);
+
+    CHECK(pool.open(&second) == pCli);
+    CHECK(second.take() == CLI_PROMPT);
+
+    /* Echo is on again, the partial line and the history are gone */
+    second.feed("x\x7f\033[A");
+    drain(pCli, second);
+    CHECK(second.take() == "x\b\033[0K\a");
+
+    second.feed("\r");
+    drain(pCli, second);
+    CHECK(calls == 1);
+    CHECK(first.out.find("half") == std::string::npos);
+}
+
+int main(void) {
+    testReuse();
+
+    return hostResult();
+}
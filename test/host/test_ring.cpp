@@ -0,0 +1,79 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+/*
+ * Feeds the receive ring from a second thread, standing in for a UART
+ * interrupt or the second core, while the main thread calls loop(). Built with
+ * the ThreadSanitizer, which reports any access to the ring which is not
+ * ordered by its atomic indices.
+ */
+
+#include <atomic>
+#include <string.h>
+#include <thread>
+#include "host.hpp"
+#include "cli/cli.hpp"
+
+static TestStream io;
+Stream &Serial = io;
+static std::atomic<unsigned long> calls(0);
+static std::atomic<unsigned long> corrupt(0);
+
+CLI_COMMAND(ping) {
+    if (argc != 1 || strcmp(argv[0], "0123456789") != 0) {
+        corrupt++;
+    }
+    calls++;
+    return 0;
+}
+
+int main(void) {
+    const unsigned long n = 2000;
+    Cli cli;
+
+    cli.begin(&io);
+
+    std::thread producer([&cli]() {
+        const char *line = "ping 0123456789\r";
+
+        for (unsigned long i = 0; i < n; i++) {
+            for (const char *p = line; *p != '\0'; ) {
+                /* A rejected byte is retried, so nothing is lost */
+                if (cli.pushFromIsr(*p)) {
+                    p++;
+                }
+            }
+        }
+    });
+
+    while (calls < n) {
+        cli.loop();
+        io.take();
+    }
+
+    producer.join();
+    CHECK(calls == n);
+    CHECK(corrupt == 0);
+    return hostResult();
+}
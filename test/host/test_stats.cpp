@@ -0,0 +1,106 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+/*
+ * Checks the execution statistics of commands, measured by micros() of the
+ * stand-in.
+ */
+
+#include <chrono>
+#include <string.h>
+#include <thread>
+#include "host.hpp"
+#include "cli/cli.hpp"
+
+static TestStream io;
+Stream &Serial = io;
+static Cli cli;
+
+CLI_COMMAND(sleepy) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    return argc > 0 ? 1 : 0;
+}
+
+CLI_COMMAND_TASK(slices) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    return ctx.call < 2 ? CLI_CMD_BUSY : 0;
+}
+
+static const cliCmdStats_t* statsOf(const char *name) {
+    const cliCmd_t *pCmd = CliCommand::find(name, strlen(name));
+
+    return CliCommand::getStats(pCmd - CliCommand::getTable());
+}
+
+/**
+ * @brief Calls and failures are counted, the times are in microseconds.
+ */
+static void testCommand(void) {
+    const cliCmdStats_t *pStats = nullptr;
+
+    CHECK(cli.execLine("sleepy", 6) == 0);
+    CHECK(cli.execLine("sleepy x", 8) == 1);
+
+    pStats = statsOf("sleepy");
+    CHECK(pStats->calls == 2);
+    CHECK(pStats->fails == 1);
+    CHECK(pStats->last >= 2000);
+    CHECK(pStats->max >= pStats->last);
+    CHECK(pStats->total >= 4000);
+    CHECK(pStats->total < 1000000);
+
+    io.take();
+    CHECK(cli.execLine("cmdstat reset", 13) == 0);
+    CHECK(statsOf("sleepy")->calls == 0);
+    CHECK(cli.execLine("cmdstat", 7) == 0);
+    CHECK(io.take().find("sleepy") != std::string::npos);
+}
+
+/**
+ * @brief A task is counted once it has finished, its time is the sum of all
+ * of its calls.
+ */
+static void testTask(void) {
+    const cliCmdStats_t *pStats = statsOf("slices");
+
+    io.feed("slices\r");
+    cli.loop();
+    CHECK(cli.isBusy());
+    CHECK(pStats->calls == 0);
+
+    while (cli.isBusy()) {
+        cli.loop();
+    }
+    CHECK(pStats->calls == 1);
+    CHECK(pStats->fails == 0);
+    CHECK(pStats->total >= 3000);
+}
+
+int main(void) {
+    cli.begin(&io);
+    testCommand();
+    testTask();
+
+    return hostResult();
+}
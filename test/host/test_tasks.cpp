@@ -0,0 +1,87 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+/*
+ * Checks task commands and the input received while one of them is running.
+ */
+
+#include <string.h>
+#include "host.hpp"
+#include "cli/cli.hpp"
+
+static TestStream io;
+Stream &Serial = io;
+static Cli cli;
+static uint32_t steps = 0;
+static bool pinged = false;
+
+CLI_COMMAND_TASK(count) {
+    steps++;
+    return ctx.call < 2 ? CLI_CMD_BUSY : 0;
+}
+
+CLI_COMMAND(ping) {
+    pinged = true;
+    return 0;
+}
+
+/**
+ * @brief Typed input is deferred by loop() while a task is running, bytes
+ * passed to read(char) can't be deferred and are counted as dropped.
+ */
+static void testDeferredInput(void) {
+    io.feed("count\r");
+    cli.loop();
+    CHECK(cli.isBusy());
+    CHECK(steps == 1);
+
+    io.feed("ping\r");
+    io.take();
+    CHECK(cli.read('x') == 0);
+    CHECK(cli.read('y') == 0);
+    CHECK(cli.getTaskDrops() == 2);
+    CHECK(io.take() == "\a\a");
+
+    cli.loop();
+    CHECK(cli.isBusy());
+    CHECK(!pinged);
+    cli.loop();
+    CHECK(!cli.isBusy());
+    CHECK(steps == 3);
+    CHECK(!pinged);
+
+    /* The dropped bytes must not show up in the deferred line */
+    while (cli.hasPendingWork()) {
+        cli.loop();
+    }
+    CHECK(pinged);
+    CHECK(cli.getTaskDrops() == 2);
+}
+
+int main(void) {
+    cli.begin(&io);
+    testDeferredInput();
+
+    return hostResult();
+}
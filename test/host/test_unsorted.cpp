@@ -0,0 +1,144 @@
+/*
+ * libcli, a simple and generic command line interface with small footprint for
+ * bare metal embedded projects.
+ *
+ * Copyright (C) 2026 Julian Friedrich
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * This project is hosted on GitHub:
+ *   https://github.com/fjulian79/libcli
+ * Please feel free to file issues, open pull requests, or contribute there.
+ */
+
+/*
+ * Checks lookups in a command table which is left unsorted by
+ * begin(..., false). Commands are registered in the order of their
+ * definition, which is not alphabetical here.
+ */
+
+#include <string.h>
+#include <string>
+#include "host.hpp"
+#include "cli/cli.hpp"
+
+static TestStream io;
+Stream &Serial = io;
+static Cli cli;
+static std::string seen;
+
+CLI_COMMAND(zeta) {
+    seen = "zeta";
+    return 0;
+}
+
+CLI_COMMAND(led_on) {
+    seen = "led_on";
+    return 0;
+}
+
+CLI_COMMAND(ping) {
+    seen = "ping";
+    return 0;
+}
+
+CLI_COMMAND(led_off) {
+    seen = "led_off";
+    return 0;
+}
+
+CLI_COMMAND(led_blink) {
+    seen = "led_blink";
+    return 0;
+}
+
+static void drain(void) {
+    while (io.available() > 0 || cli.hasPendingWork()) {
+        cli.loop();
+    }
+}
+
+static const cliCmdStats_t* statsOf(const char *name) {
+    const cliCmd_t *pCmd = CliCommand::find(name, strlen(name));
+
+    return CliCommand::getStats(pCmd - CliCommand::getTable());
+}
+
+/**
+ * @brief Completion scans the unsorted table instead of sorting it, which
+ * would reset the statistics.
+ */
+static void testCompletion(void) {
+    CHECK(CliCommand::exec(io, "ping", nullptr, 0) == 0);
+    CHECK(statsOf("ping")->calls == 1);
+    io.take();
+
+    /* Three matches spread over the table, completed to their common prefix
+     * and listed in the order of the table */
+    io.feed("le\t");
+    drain();
+    CHECK(io.take() == "led_\nled_on      led_off     led_blink\n#>led_");
+
+    /* A longer prefix narrows the matches */
+    io.feed("o\t");
+    drain();
+    CHECK(io.take() == "o\nled_on    led_off\n#>led_o");
+    io.feed("f\t");
+    drain();
+    CHECK(io.take() == "ff ");
+
+    io.feed("\x0bz\t");
+    drain();
+    CHECK(io.take() == "\r\033[2K#>zeta ");
+
+    CHECK(!CliCommand::isSorted());
+    CHECK(statsOf("ping")->calls == 1);
+    io.feed("\x0b");
+    drain();
+}
+
+/**
+ * @brief An abbreviated command is resolved by scanning the unsorted table,
+ * which is neither sorted nor are the statistics reset.
+ */
+static void testDispatch(void) {
+    std::string out;
+
+    seen.clear();
+    io.feed("ze\r");
+    drain();
+    io.take();
+    CHECK(seen == "zeta");
+
+    /* The matches are spread over the table and listed in its order */
+    seen.clear();
+    io.feed("led_o\r");
+    drain();
+    out = io.take();
+    CHECK(seen.empty());
+    CHECK(out.find("Error, ambiguous command: led_o\nMatches: led_on "
+        "led_off\n") != std::string::npos);
+
+    CHECK(!CliCommand::isSorted());
+    CHECK(statsOf("ping")->calls == 1);
+    CHECK(statsOf("zeta")->calls == 1);
+}
+
+int main(void) {
+    cli.begin(&io, false);
+    testCompletion();
+    testDispatch();
+
+    return hostResult();
+}